@@ -72,7 +72,7 @@
 #define configUSE_PREEMPTION		1
 #define configUSE_IDLE_HOOK			1
 #define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 8 )
-#define configUSE_TICK_HOOK			0
+#define configUSE_TICK_HOOK			1   /* run-time counter wrap extension */
 #define configCPU_CLOCK_HZ			( ( unsigned long ) SystemCoreClock )
 #define configTICK_RATE_HZ			( ( portTickType ) 1000 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 128 )
@@ -93,7 +93,16 @@
 #define configCHECK_FOR_STACK_OVERFLOW	0
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configQUEUE_REGISTRY_SIZE		10
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* Run-time stats count DWT cycles (enabled in app_io_init()), extended past the
+32-bit wrap in main_rtos.c from the tick hook. */
+#ifndef __ASSEMBLER__
+extern void rtos_runtime_init(void);
+extern unsigned long rtos_runtime_counter(void);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	rtos_runtime_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()			rtos_runtime_counter()
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
@@ -0,0 +1,24 @@
+/**
+ * @file app_io.h
+ * @brief Peripheral bring-up and per-bus TX service, shared by both main loops.
+ *
+ * - app_io_init(): UARTs, NVIC priorities (IRQ_PRIO_*), RIT, DWT, WS.
+ * - app_io_service_*(): send at most one prepared frame on one bus; return
+ *   true if something was sent. The superloop (main.c) calls them in turn;
+ *   the FreeRTOS build (main_rtos.c) gives each bus its own task.
+ */
+
+#ifndef INC_APP_IO_H_
+#define INC_APP_IO_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+void app_io_init(void);
+
+bool app_io_service_app_tx(void);             // UART0: prepared status frame
+bool app_io_service_slave_tx(uint8_t seg);    // UART1 / UART3: one queued slave frame
+bool app_io_service_bin_tx(void);             // UART2: one queued BIN frame
+
+#endif /* INC_APP_IO_H_ */
@@ -3,7 +3,8 @@
  * @brief App-status frame builder and shared configuration state.
  *
  * Responsibilities:
- * - Owns cfg_conn[] / cfg_count (connectors map uploaded by the App).
+ * - Owns cfg_conn[] / cfg_count (connectors map uploaded by the App), and the
+ *   per-segment split of it (cfg_seg_conn[][], g_con_seg[], g_seg_conn_mask[]).
  * - Maintains button/status masks (g_status_ext, one-shot/force-01 masks).
  * - Builds GRP_RX_TO_APP SC_STATUS frames into an internal buffer.
  * - Exposes "prepare/peek/send" accessors used by the main loop.
@@ -36,6 +37,14 @@ extern volatile uint32_t g_force01_while_triggered_mask;
 extern uint8_t  cfg_conn[MAX_CFG];
 extern uint8_t  cfg_count;
 
+// Slave-bus segment of each connector (SC_SEG_MAP: listed → UART3, others → UART1)
+extern uint8_t  cfg_seg_conn[SLV_SEGS][MAX_CFG];
+extern uint8_t  cfg_seg_count[SLV_SEGS];
+extern uint8_t  g_con_seg[32];             // by connector 1..31; unmapped → 0
+extern uint32_t g_seg_conn_mask[SLV_SEGS]; // CONN_BIT()s owned by each segment
+
+static inline uint8_t con_seg(uint8_t con){ return (con >= 1 && con <= 31) ? g_con_seg[con] : 0; }
+
 // Build status frame into internal buffer and mark ready
 void request_status_reply(void);
 
@@ -46,5 +55,6 @@ void         app_status_mark_sent(void);
 
 // Handlers that modify config/status
 void handle_upload_map(const uint8_t *pay, uint8_t pal);
+void handle_seg_map(const uint8_t *pay, uint8_t pal);
 
 #endif /* INC_APP_STATUS_H_ */
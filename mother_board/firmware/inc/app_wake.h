@@ -0,0 +1,33 @@
+/**
+ * @file app_wake.h
+ * @brief ISR → consumer wake-up hook for the bus TX and WS work.
+ *
+ * - ISRs call app_wake_from_isr() after queuing work for a consumer.
+ * - Superloop build: a no-op, the main loop wakes from __WFI on any IRQ.
+ * - FreeRTOS build (APP_USE_FREERTOS): vTaskNotifyGiveFromISR() to the task
+ *   that owns the source (main_rtos.c). Callers must run at an NVIC priority
+ *   numerically >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (IRQ_PRIO_*).
+ */
+
+#ifndef INC_APP_WAKE_H_
+#define INC_APP_WAKE_H_
+
+#pragma once
+#include <stdint.h>
+#include "config.h"
+
+enum {
+    WAKE_APP_TX = 0,     // status frame prepared
+    WAKE_BIN_TX,         // UART2 queue
+    WAKE_WS,             // WS flush requested with a dirty buffer
+    WAKE_SLV_TX,         // slave queue of segment 0; segment s = WAKE_SLV_TX + s
+    WAKE_COUNT = WAKE_SLV_TX + SLV_SEGS
+};
+
+#if APP_USE_FREERTOS
+void app_wake_from_isr(uint8_t src);
+#else
+static inline void app_wake_from_isr(uint8_t src){ (void)src; }
+#endif
+
+#endif /* INC_APP_WAKE_H_ */
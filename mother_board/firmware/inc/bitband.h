@@ -0,0 +1,56 @@
+/**
+ * @file bitband.h
+ * @brief Interrupt-safe updates of 32-bit masks shared between ISRs of different priority.
+ *
+ * - Single bits: Cortex-M3 bit-band alias. One store to the alias word sets or
+ *   clears one bit of the target word atomically, so a higher-priority ISR
+ *   running in between cannot lose its own update.
+ * - Several bits at once: LDREX/STREX retry loop (mask_or/andnot/assign/take).
+ *
+ * The bit-band region is 0x20000000..0x200FFFFF. On the LPC17xx that is the AHB
+ * SRAM (RamAHB32 at 0x2007C000); the main SRAM at 0x10000000 has no alias.
+ * Shared masks are therefore defined with BITBAND_RAM (.bss.$RAM2, the AHB SRAM
+ * bank in the MCUXpresso managed linker script).
+ */
+
+#ifndef INC_BITBAND_H_
+#define INC_BITBAND_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "chip.h"   // CMSIS __LDREXW / __STREXW
+
+#define BITBAND_RAM          __attribute__((section(".bss.$RAM2")))
+
+#define BITBAND_SRAM_BASE    0x20000000u
+#define BITBAND_SRAM_ALIAS   0x22000000u
+#define BITBAND_ALIAS(addr, bit) \
+    ((volatile uint32_t *)(BITBAND_SRAM_ALIAS + (((uintptr_t)(addr) - BITBAND_SRAM_BASE) << 5) + ((uintptr_t)(bit) << 2)))
+
+// bit 0..31 of a BITBAND_RAM word
+static inline void bb_set(volatile uint32_t *w, uint8_t bit){ *BITBAND_ALIAS(w, bit) = 1u; }
+static inline void bb_clr(volatile uint32_t *w, uint8_t bit){ *BITBAND_ALIAS(w, bit) = 0u; }
+static inline void bb_write(volatile uint32_t *w, uint8_t bit, bool on){ *BITBAND_ALIAS(w, bit) = on ? 1u : 0u; }
+
+static inline void mask_or(volatile uint32_t *w, uint32_t m){
+    uint32_t v;
+    do { v = __LDREXW(w) | m; } while (__STREXW(v, w));
+}
+static inline void mask_andnot(volatile uint32_t *w, uint32_t m){
+    uint32_t v;
+    do { v = __LDREXW(w) & ~m; } while (__STREXW(v, w));
+}
+// *w = (*w & ~m) | (v & m)
+static inline void mask_assign(volatile uint32_t *w, uint32_t m, uint32_t v){
+    uint32_t o;
+    do { o = __LDREXW(w); } while (__STREXW((o & ~m) | (v & m), w));
+}
+// Clear the m bits and return what they were
+static inline uint32_t mask_take(volatile uint32_t *w, uint32_t m){
+    uint32_t o;
+    do { o = __LDREXW(w); } while (__STREXW(o & ~m, w));
+    return o & m;
+}
+
+#endif /* INC_BITBAND_H_ */
@@ -0,0 +1,30 @@
+/**
+ * @file bitmap.h
+ * @brief 32-bit target bitmaps with constant-time bit scans (Cortex-M3 RBIT/CLZ).
+ *
+ * - Bit (i-1) stands for target i, same layout as CONN_BIT() (connectors 1..31,
+ *   BIN ids 1..MAX_BIN).
+ * - bitmap_first(): lowest set bit.
+ * - bitmap_next(): first set bit at or after a position, wrapping around;
+ *   this is the round-robin pick used by the LED job schedulers.
+ *
+ * Both return 0xFF for an empty mask.
+ */
+
+#ifndef INC_BITMAP_H_
+#define INC_BITMAP_H_
+
+#pragma once
+#include <stdint.h>
+#include "chip.h"   // CMSIS __RBIT / __CLZ
+
+static inline uint8_t bitmap_first(uint32_t m){
+    return m ? (uint8_t)__CLZ(__RBIT(m)) : 0xFF;
+}
+
+static inline uint8_t bitmap_next(uint32_t m, uint8_t from){
+    const uint32_t hi = m & ~((1u << (from & 31u)) - 1u);
+    return bitmap_first(hi ? hi : m);
+}
+
+#endif /* INC_BITMAP_H_ */
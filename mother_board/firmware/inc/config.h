@@ -12,21 +12,83 @@
 #ifndef INC_CONFIG_H_
 #define INC_CONFIG_H_
 
+// Main loop: 0 = superloop (main.c), 1 = FreeRTOS tasks per bus (main_rtos.c).
+// 1 needs the FreeRTOS kernel (tasks/queue/list, portable/GCC/ARM_CM3, a heap_x.c) in the project.
+#define APP_USE_FREERTOS         0
+
+// NVIC priorities (lower = more urgent). Same order in both builds; with FreeRTOS
+// every ISR that wakes a task must sit at or below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (5).
+#if APP_USE_FREERTOS
+#define IRQ_PRIO_WS_DMA          4     // WS chunk refill (WS_DMA_STREAM); no FreeRTOS calls
+#define IRQ_PRIO_RIT             5
+#define IRQ_PRIO_SLV             6     // UART1/2/3 RX, GPIO buttons
+#define IRQ_PRIO_APP             7     // UART0 (App commands)
+#else
+#define IRQ_PRIO_WS_DMA          0
+#define IRQ_PRIO_RIT             1
+#define IRQ_PRIO_SLV             2
+#define IRQ_PRIO_APP             3
+#endif
+
 // Timers
 #define RIT_TICK_MS              70
 #define APP_IDLE_MS              2000
 #define APP_IDLE_TICKS           ((APP_IDLE_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+// Idle watchdog: OFF burst on entry, then quiet with an optional slow reassert
+#define IDLE_OFF_REPEATS         3
+#define IDLE_OFF_SPACING_MS      350
+#define IDLE_OFF_SPACING_TICKS   ((IDLE_OFF_SPACING_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+#define IDLE_REASSERT_MS         60000 // one OFF per bus this often while idle (0 = never)
+#define IDLE_REASSERT_TICKS      ((IDLE_REASSERT_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+
+// Tick domains: slave buses, BIN and WS each run on their own TIMER0 match channel
+// (1 MHz) instead of every RIT tick. RIT keeps g_tick, the job mailbox and the idle
+// watchdog. Periods can be changed at run time with SC_TICK_PERIODS. 0 = all on RIT.
+#define TICK_DOMAINS             1
+#define DOM_SLV_MS               20    // slave poll / LED frame per segment
+#define DOM_BIN_MS               20    // BIN LED frame
+#define DOM_WS_MS                33    // WS flush request (~30 fps)
+#define DOM_SLV_MIN_MS           17    // poll (9 B) + reply (6 B) @9600 + turnaround
+#define DOM_MIN_MS               5
+
+// Tickless: while nothing is due (App idle, no transaction, or no polling and no
+// LED jobs) RIT is re-programmed as a one-shot to the next deadline and TIMER0 is
+// stopped, so the core sleeps in __WFI until then or until the next App byte.
+#define TICKLESS                 0
+#define TICKLESS_MAX_TICKS       1024  // longest RIT span (~72 s); RIT counter limit ~170 s @25 MHz
 
 // Sizes
 #define MAX_CFG                  31
-#define WS_LED_COUNT             120
-#define MAX_U1_JOBS              32
-#define MAX_U2_JOBS              16
-#define U1_TXQ_CAP               128
+#define WS_LED_COUNT             120   // per WS strip (16-bit; see WS_SEGMENTS / WS_DMA_STREAM)
+#define MAX_U1_JOBS              32    // one slot per connector, index = con (1..31)
+#define MAX_BIN                  16    // BIN ids 1..MAX_BIN (<= 32: one bitmap bit each)
+#define MAX_U2_JOBS              (MAX_BIN + 1)   // one slot per BIN id, index = bin
+#define U1_TXQ_CAP               128   // per slave-bus segment
 #define U2_TXQ_CAP               128
+#define JOB_MBOX_CAP             64    // App → RIT job operations per tick (SC_STATUS posts one per connector)
 #define RX_LEN_MAX               (4 + 2 * MAX_CFG)
 #define TX_FRAME_MAX             (MAX_CFG + 10)
 
+// LED jobs are emitted only when the desired LED differs from the last one
+// sent, plus one keepalive refresh per target every LED_KEEPALIVE_MS (0 = never)
+#define LED_KEEPALIVE_MS         1000
+#define LED_KEEPALIVE_TICKS      ((LED_KEEPALIVE_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+
+// Per-job refresh period / priority (LED_CTRL flags, see proto.h LEDF_*).
+// Jobs are emitted earliest-deadline-first; an urgent change is scheduled as if
+// its deadline had passed LED_URGENT_LEAD_TICKS ago.
+#define LED_SLOW_REFRESH_MS      5000
+#define LED_SLOW_REFRESH_TICKS   ((LED_SLOW_REFRESH_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+#define LED_URGENT_LEAD_TICKS    8
+
+// Acknowledged LED delivery on UART1/UART2: slaves echo the LED they show in
+// their status reply ([0A, addr, st, led]); a frame that is still unconfirmed
+// after LED_ACK_TIMEOUT_MS is resent. Needs matching slave firmware.
+// With acks on, LED_KEEPALIVE_MS can usually be 0.
+#define LED_ACK_MODE             0
+#define LED_ACK_TIMEOUT_MS       280
+#define LED_ACK_TIMEOUT_TICKS    ((LED_ACK_TIMEOUT_MS + RIT_TICK_MS - 1) / RIT_TICK_MS)
+
 // Buttons (GPIO pins are set in main)
 #define BTN_P24_BIT 0x01  // S1 (adds +1)
 #define BTN_P23_BIT 0x02  // S2 (adds +2)
@@ -39,5 +101,59 @@
 // 0 = no throttling; 2 means ~140 ms min gap between strip flushes
 #define WS_MIN_FLUSH_TICKS  0
 #define WS_HAS_STRIP2       1
+#define WS_STRIPS           (WS_HAS_STRIP2 ? 2 : 1)
+// WS segments: one WS_SEGMENT(strip, BIN id, first LED on the strip (0-based), LED count)
+// per range. A long strip can carry several BINs end to end: BIN LED n lights strip LED
+// first + n - 1. SC_BIN_MASK drives the BIN 1 segments. Default: every strip mirrors BIN 1
+// in full. ws_led.c fails the build if a segment lies outside its strip.
+#if WS_HAS_STRIP2
+#define WS_SEGMENTS         WS_SEGMENT(0, 1, 0, WS_LED_COUNT) WS_SEGMENT(1, 1, 0, WS_LED_COUNT)
+#else
+#define WS_SEGMENTS         WS_SEGMENT(0, 1, 0, WS_LED_COUNT)
+#endif
+// WS framebuffer (ws_pal.h): palette index per LED, 2 bits (4 colours) or 4 bits (16).
+// WS_BRIGHTNESS (0..255) and gamma are folded into the palette at compile time.
+#define WS_PAL_BITS         2
+#define WS_BRIGHTNESS       255
+// WS effect slots (SC_WS_EFFECT): blink / pulse / chase over an LED range, run by the WS domain
+#define WS_FX_MAX           8
+
+// WS2812 output backend (ws_hw.h). BITBANG: P3.25/P3.26, interrupts masked while a
+// frame is clocked out (~3.6 ms per strip). SSP_DMA: SSP0/SSP1 MOSI (P0.18/P0.9) fed by
+// GPDMA, interrupts stay enabled; needs the strip data lines rewired. TIMER_DMA: GPDMA
+// writes P3.25/P3.26 SET/CLR paced by TIMER2/TIMER3 matches; no rewiring, no CPU.
+#define WS_BACKEND_BITBANG  0
+#define WS_BACKEND_SSP_DMA  1
+#define WS_BACKEND_TIMER_DMA 2
+#define WS_BACKEND          WS_BACKEND_BITBANG
+// DMA backends: 0 = whole frame kept pre-encoded (SSP 9 B, TIMER 24 B per LED, one GPDMA
+// transfer); 1 = encode WS_DMA_CHUNK_LEDS at a time into two ping-pong buffers from the
+// DMA interrupt while the frame is sent. Needed for long strips.
+#define WS_DMA_STREAM       (WS_LED_COUNT > 150)
+#define WS_DMA_CHUNK_LEDS   32    // ~1 ms on the wire: the refill deadline (<= 168 for TIMER_DMA)
+// Core clock the bit-bang WS timing is computed for (DWT cycles). Must match the PLL
+// setup: Chip_SetupXtalClocking() in board_sysinit.c runs the core at 96 MHz.
+// ws_hw_init() compares it with SystemCoreClock and keeps the output off on a mismatch.
+#define WS_CORE_CLOCK_HZ    96000000UL
+
+// Slave-bus segments: connectors are sharded over UART1 (segment 0) and UART3
+// (segment 1) by the map upload; each segment polls and streams independently.
+#define SLV_SEGS            2
+
+// UART1 TDMA poll: one broadcast, slaves reply in slots derived from their address.
+// Needs slave firmware that understands SLV_SUB_POLL_ALL; 0 keeps the per-connector poll.
+#define U1_POLL_TDMA        0
+#define U1_TDMA_SLOT_MS     8     // >= one 6-byte reply @9600 (~6.3 ms) + turnaround
+#define U1_BYTE_US          1042  // one 8N1 byte @9600
+
+// SC_STATUS "LED#1 on many connectors" as one SLV_SUB_LED_MULTI frame instead of
+// one U1Job per connector. Needs matching slave firmware; 0 keeps per-connector jobs.
+#define U1_LED_MULTICAST    0
+
+// Slave/BIN-bus transactions (xact.h): send, await reply, retry. One owns a bus
+// at a time; further ones queue behind it. LED_ACK_MODE sends LED-ONs this way.
+#define XACT_MAX            4
+#define XACT_TIMEOUT_TICKS  2     // reply wait per try (>= poll + reply @9600 + one tick)
+#define XACT_RETRIES        2
 
 #endif /* INC_CONFIG_H_ */
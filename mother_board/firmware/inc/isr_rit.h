@@ -4,12 +4,18 @@
  *
  * Duties every tick:
  * - Handle OFF broadcasts requested by other modules.
- * - Check App idle watchdog; on idle ⇒ broadcast OFF, clear WS, pause work.
- * - If LED jobs active ⇒ emit one UART1 LED-ON (u1_scheduler_emit_one()).
- * - Else ⇒ run round-robin poll over configured connectors; at start of a
- *   new poll cycle, commit last round's masks via sched_commit_and_clear_poll_round().
- * - Emit at most one UART2 BIN LED-ON per tick (u2_scheduler_emit_one()).
- * - Request WS flush when needed; actual flush is in main loop.
+ * - App idle watchdog: on entry clear WS and send a short burst of OFF
+ *   broadcasts, then stay quiet (optional slow reassert) and pause work until
+ *   the next App byte.
+ *
+ * Domain bodies (own TIMER0 period each with TICK_DOMAINS, else every RIT tick):
+ * - dom_slv_tick(), per slave segment (UART1, UART3): if LED jobs due ⇒ emit
+ *   one LED-ON (u1_scheduler_emit_one(seg)); else ⇒ poll the segment's connectors
+ *   round-robin and, at the start of its cycle, commit that segment's bits of the
+ *   masks via sched_commit_and_clear_poll_round(g_seg_conn_mask[seg]). Skipped
+ *   while the segment's TX ring still holds a frame.
+ * - dom_bin_tick(): at most one UART2 BIN LED-ON (u2_scheduler_emit_one()).
+ * - dom_ws_tick(): request WS flush; actual flush is in main loop.
  *
  * Keeps ISRs short by only queuing frames; main loop performs UART TX.
  */
@@ -20,4 +26,9 @@
 #pragma once
 void RIT_IRQHandler(void);
 
+// Domain bodies: TIMER0 match channels (TICK_DOMAINS) or RIT, never both
+void dom_slv_tick(void);   // per segment: transaction, else one LED frame, else poll
+void dom_bin_tick(void);   // one BIN LED frame
+void dom_ws_tick(void);    // WS flush request
+
 #endif /* INC_ISR_RIT_H_ */
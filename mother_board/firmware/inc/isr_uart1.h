@@ -2,9 +2,17 @@
  * @file isr_uart1.h
  * @brief UART1 (Slave→RX) byte-stream ISR declaration.
  *
- * - Parses SC_STATUS replies from slaves (address, state).
+ * - Parses SC_STATUS replies from slaves (address, state) on segment 0.
+ * - slave_rx_status(): shared reply handling, also used by UART3 (segment 1);
+ *   replies from connectors mapped to another segment are ignored.
  * - Updates round_alive_mask / round_triggered_mask.
  * - If streaming is active, also mirrors into g_alive_mask / g_triggered_mask.
+ * - LED_ACK_MODE: a 4-byte reply [0A, addr, st, led] confirms the slave's LED
+ *   into g_u1_ack_led[addr].
+ * - U1_POLL_TDMA: while a broadcast-poll window is open, a reply is only
+ *   accepted if it lands in the slot owned by its address (DWT timed). The
+ *   window carries the stamp of the RIT round it belongs to, so a broadcast
+ *   sent after its round closed never opens one.
  *
  * The actual polling frames (and LED-ON frames) are queued by the RIT
  * scheduler via u1_jobs and queues modules.
@@ -14,6 +22,24 @@
 #define INC_ISR_UART1_H_
 
 #pragma once
+#include <stdint.h>
+#include "config.h"
+
 void UART1_IRQHandler(void);
 
+// Apply one complete slave reply body received on segment `seg`
+void slave_rx_status(uint8_t seg, const uint8_t *pay, uint8_t len);
+
+#if U1_POLL_TDMA
+// RIT: a broadcast poll was queued on `seg`, a round starts
+void     u1_tdma_round_arm(uint8_t seg);
+// Main loop: round stamp, read before popping the frame it may belong to
+uint32_t u1_tdma_round(uint8_t seg);
+// Main loop: broadcast poll of `round` has fully left the wire, slot 1 starts now.
+// Ignored if RIT already closed that round (late send).
+void     u1_tdma_window_open(uint8_t seg, uint32_t round);
+// RIT: round on `seg` is over, accept replies by address only
+void     u1_tdma_window_close(uint8_t seg);
+#endif
+
 #endif /* INC_ISR_UART1_H_ */
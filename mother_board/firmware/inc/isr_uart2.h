@@ -0,0 +1,21 @@
+/**
+ * @file isr_uart2.h
+ * @brief UART2 (BIN→RX) byte-stream ISR declaration.
+ *
+ * - Only used with LED_ACK_MODE: BIN slaves answer LED frames with
+ *   [SC_STATUS, bin, st, led] and the ISR stores `led` into g_u2_ack_led[bin].
+ * - Framing: the shared slave-bus parser (slv_frame.h), as on UART1/UART3.
+ * - Every frame is then offered to xact_rx(XACT_BUS_BIN, ...): the LED-ON
+ *   read-back transaction waits for exactly this reply.
+ *
+ * The u2_jobs scheduler compares the confirmed LED with its shadow and only
+ * resends unconfirmed frames.
+ */
+
+#ifndef INC_ISR_UART2_H_
+#define INC_ISR_UART2_H_
+
+#pragma once
+void UART2_IRQHandler(void);
+
+#endif /* INC_ISR_UART2_H_ */
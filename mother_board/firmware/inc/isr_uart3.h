@@ -0,0 +1,17 @@
+/**
+ * @file isr_uart3.h
+ * @brief UART3 (Slave→RX, segment 1) byte-stream ISR declaration.
+ *
+ * - Same framing as isr_uart1.c (shared slv_frame.h parser), for the
+ *   connectors SC_SEG_MAP put on the second slave bus.
+ * - Complete replies go through slave_rx_status(1, ...), so masks, TDMA slot
+ *   checks and LED acks behave exactly as on UART1.
+ */
+
+#ifndef INC_ISR_UART3_H_
+#define INC_ISR_UART3_H_
+
+#pragma once
+void UART3_IRQHandler(void);
+
+#endif /* INC_ISR_UART3_H_ */
@@ -0,0 +1,59 @@
+/**
+ * @file job_mbox.h
+ * @brief Lock-free SPSC mailbox of LED job operations (UART0 handlers → RIT).
+ *
+ * - The App handlers (UART0 ISR) never touch the job tables: they post typed
+ *   operations with job_mbox_post().
+ * - RIT applies every queued operation at the start of its tick
+ *   (job_mbox_apply_all()), so u1_jobs / u2_jobs have a single writer and
+ *   need no NVIC masking.
+ * - Operations are applied in posting order; a full mailbox drops the op and
+ *   counts it in job_mbox_drops.
+ * - JOB_OP_U2_MASK sends the SC_BIN_MASK frames from RIT, so the UART2 TX
+ *   ring keeps RIT as its single producer. The list is too long for a JobOp
+ *   and is staged beside the mailbox (latest wins).
+ */
+
+#ifndef INC_JOB_MBOX_H_
+#define INC_JOB_MBOX_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+typedef enum {
+    JOB_OP_START = 0,    // start/refresh (bus, id, led, flags)
+    JOB_OP_REPLACE,      // reset-on-new: drop the target's other LED, then start
+    JOB_OP_STOP_ALL,     // stop every job on the buses in `bus`, invalidate their shadows
+    JOB_OP_U1_MULTI,     // connectors in `mask` leave their jobs and join the multicast job (led)
+    JOB_OP_U2_MASK       // send the staged BIN mask list (job_mbox_u2_mask())
+} JobOpKind;
+
+#define JOB_BUS_U1 0x01  // slave buses (u1_jobs)
+#define JOB_BUS_U2 0x02  // BIN bus (u2_jobs)
+
+typedef struct {
+    uint8_t  op, bus, id, led, flags;
+    uint32_t mask;
+} JobOp;
+
+extern volatile uint32_t job_mbox_drops;
+
+bool job_mbox_post(const JobOp *op);   // producer: UART0 ISR only
+void job_mbox_apply_all(void);         // consumer: RIT only
+
+// Shorthands for the handlers
+static inline bool job_mbox_replace(uint8_t bus, uint8_t id, uint8_t led, uint8_t flags){
+    const JobOp op = { JOB_OP_REPLACE, bus, id, led, flags, 0 };
+    return job_mbox_post(&op);
+}
+// Stage an SC_BIN_MASK list and post JOB_OP_U2_MASK (UART0 ISR only)
+bool job_mbox_u2_mask(uint8_t max_led, const uint8_t *list);
+
+static inline bool job_mbox_stop_all(uint8_t bus){
+    const JobOp op = { JOB_OP_STOP_ALL, bus, 0, 0, 0, 0 };
+    return job_mbox_post(&op);
+}
+
+#endif /* INC_JOB_MBOX_H_ */
@@ -0,0 +1,57 @@
+/**
+ * @file led_shadow.h
+ * @brief Per-target "last sent" LED shadow for change-only emission.
+ *
+ * - The desired state is the job table entry (u1_jobs / u2_jobs).
+ * - LedShadow records what was last put on the wire for a target, and when.
+ * - led_shadow_due(): emit only if desired != sent, or the job's refresh
+ *   period (ticks, 0 = never) has expired since the last send.
+ * - led_job_period(): refresh period for a job's LEDF_* flags (LED_CTRL).
+ * - LED_ACK_MODE: led_shadow_due_acked() also resends a frame the slave has
+ *   not confirmed (reported LED != desired) after LED_ACK_TIMEOUT_TICKS.
+ * - After an OFF broadcast or a mask frame the slave state is unknown:
+ *   invalidate the shadows so the next job for every target is resent.
+ *
+ * Pure inline helpers; callers own the storage and run in RIT context.
+ */
+
+#ifndef INC_LED_SHADOW_H_
+#define INC_LED_SHADOW_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "proto.h"
+
+typedef struct {
+    uint8_t  led;    // last LED sent, 0 = nothing / unknown
+    uint16_t tick;   // when it was sent
+} LedShadow;
+
+static inline bool led_shadow_due(const LedShadow *s, uint8_t want, uint16_t now, uint16_t period){
+    if (s->led != want) return true;
+    return period && (int16_t)((uint16_t)(now - s->tick)) >= (int16_t)period;
+}
+
+#if LED_ACK_MODE
+static inline bool led_shadow_due_acked(const LedShadow *s, uint8_t want, uint8_t acked, uint16_t now, uint16_t period){
+    if (led_shadow_due(s, want, now, period)) return true;
+    return acked != want &&
+           (int16_t)((uint16_t)(now - s->tick)) >= (int16_t)LED_ACK_TIMEOUT_TICKS;
+}
+#endif
+
+static inline void led_shadow_sent(LedShadow *s, uint8_t led, uint16_t now){
+    s->led = led; s->tick = now;
+}
+
+static inline void led_shadow_invalidate(LedShadow *s){ s->led = 0; }
+
+static inline uint16_t led_job_period(uint8_t flags){
+    if (flags & LEDF_ONESHOT) return 0;
+    if (flags & LEDF_SLOW)    return LED_SLOW_REFRESH_TICKS;
+    return LED_KEEPALIVE_TICKS;
+}
+
+#endif /* INC_LED_SHADOW_H_ */
@@ -31,10 +31,31 @@ enum {
   SC_STATUS=0x0A,
   SC_BTNFLAG_RESET=0x09,
   SC_SLAVE=0x85,
-  SC_BIN_MASK=0x0B
+  SC_BIN_MASK=0x0B,
+  SC_TICK_PERIODS=0x0C,   // [slv_ms, bin_ms, ws_ms], 0 = keep (TICK_DOMAINS)
+  SC_WS_EFFECT=0x0D,      // [slot, kind, bin, led, count, colour, period_10ms, arg]; [slot, 0] stops
+                          // 10-byte form: led / count as big-endian uint16 (segments > 255 LEDs)
+  SC_SEG_MAP=0x0E         // [n, c1..cn]: connectors on UART3 (segment 1); all others on UART1
 };
 
+// RX->Slave subcodes (byte after the target address in SC_SLAVE frames)
+enum {
+  SLV_SUB_POLL=0x00,
+  SLV_SUB_LED_ON=0x02,
+  SLV_SUB_LED_OFF=0x03,
+  SLV_SUB_BIN=0x04,
+  SLV_SUB_POLL_ALL=0x05,  // TDMA broadcast poll: [0xFF, 05, slot_ms, max_addr]
+  SLV_SUB_LED_MULTI=0x06  // multicast LED-ON:   [0xFF, 06, m0, m1, m2, m3, led], bit (c-1) = connector c
+};
+#define SLV_ADDR_BROADCAST 0xFF
+
 #define RX_ID 0x01
+
+// LED_CTRL job flags (optional trailing byte of modes 0x00/0x01, byte 3 of mode 0x02)
+#define LEDF_ONESHOT  0x01   // send once (even if unchanged), then retire the job
+#define LEDF_SLOW     0x02   // refresh every LED_SLOW_REFRESH_MS instead of LED_KEEPALIVE_MS
+#define LEDF_URGENT   0x04   // deadline LED_URGENT_LEAD_TICKS ahead: beats routine refreshes
+
 #define CONN_BIT(c) (1u << ((c) - 1))
 
 
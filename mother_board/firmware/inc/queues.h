@@ -1,11 +1,13 @@
 /**
  * @file queues.h
- * @brief Lock-free single-producer/single-consumer TX rings for UART1/2.
+ * @brief Lock-free single-producer/single-consumer TX rings for the slave buses and UART2.
  *
- * - U1Frame (small fixed-size) and U2Frame (larger, up to 192 bytes).
- * - ISR-safe push:  u1q_push_isr(), u2q_push_isr()  (no malloc, non-blocking).
- * - Main-loop pop:  u1q_pop_main(),  u2q_pop_main()  (drained and sent).
- * - Drop counters:  u1_drops, u2_drops for diagnostics.
+ * - U1Frame (small fixed-size, fits a multicast LED frame) and U2Frame (up to 192 bytes).
+ * - One slave ring per bus segment (0 = UART1, 1 = UART3).
+ * - ISR-safe push:  slvq_push_isr(seg, ...), u2q_push_isr()  (no malloc, non-blocking).
+ * - Main-loop pop:  slvq_pop_main(seg, ...), u2q_pop_main()  (drained and sent).
+ * - Backlog check:  slvq_pending(seg), u2q_pending() (tick domains hold off while set).
+ * - Drop counters:  slv_drops[seg], u2_drops for diagnostics.
  *
  * Design: ISRs **only push**, main loop **only pops**.
  */
@@ -18,16 +20,18 @@
 #include <stdbool.h>
 #include "config.h"
 
-// UART1 TX ring (frames to slaves)
-typedef struct { uint8_t data[9];   uint8_t len; } U1Frame;
-bool u1q_push_isr(const uint8_t *d, uint8_t n);
-bool u1q_pop_main(U1Frame *out);
-extern volatile uint32_t u1_drops;
+// Slave-bus TX rings (frames to slaves), one per segment
+typedef struct { uint8_t data[12];  uint8_t len; } U1Frame;
+bool slvq_push_isr(uint8_t seg, const uint8_t *d, uint8_t n);
+bool slvq_pop_main(uint8_t seg, U1Frame *out);
+bool slvq_pending(uint8_t seg);               // frames still waiting for the wire
+extern volatile uint32_t slv_drops[SLV_SEGS];
 
 // UART2 TX ring (frames to BIN)
 typedef struct { uint8_t data[192]; uint8_t len; } U2Frame;
 bool u2q_push_isr(const uint8_t *d, uint8_t n);
 bool u2q_pop_main(U2Frame *out);
+bool u2q_pending(void);
 extern volatile uint32_t u2_drops;
 
 
@@ -5,17 +5,28 @@
  * Exposed timing/state:
  * - g_tick: RIT tick counter (monotonic).
  * - g_app_last_activity_tick: last time App (UART0) was active.
- * - app idle flags: g_idle_ws_cleared to avoid redundant clears.
+ * - g_app_activity: set with every such stamp, cleared by RIT on idle entry;
+ *   leaving idle tests this flag, not the (wrapping) stamp.
+ * - g_app_idle: 1 while the idle watchdog holds the buses (OFF sent, jobs paused).
  *
  * Alive/trigger bitmasks:
  * - round_* masks: accumulators per polling round (UART1 replies).
  * - g_* masks:     "current view" used for status reporting.
+ * - All four live in bit-band SRAM (bitband.h): the slave RX ISRs set/clear
+ *   single bits through the alias, RIT commits with LDREX/STREX, so no
+ *   update is lost across priorities and no IRQ is masked.
  *
  * Control flags:
  * - g_off_broadcast_pending, g_off_broadcast2_pending: request OFF frames.
  *
  * API:
- * - sched_commit_and_clear_poll_round(): snapshot round_* into g_*.
+ * - sched_commit_and_clear_poll_round(seg_mask): snapshot round_* into g_*
+ *   for the connectors of one slave-bus segment (rounds run per segment).
+ * - sched_now_tick(): current tick for ISRs/main that stamp time. With
+ *   TICKLESS, g_tick only advances when RIT fires (possibly many ticks at
+ *   once); this adds the ticks elapsed in the running RIT span.
+ * - sched_wake(): TICKLESS — end a long RIT span at the next tick boundary
+ *   (App byte while idle). No-op otherwise.
  */
 
 #ifndef INC_SCHED_H_
@@ -24,10 +35,12 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include "config.h"
 
 extern volatile uint32_t g_tick;
 extern volatile uint16_t g_app_last_activity_tick;
-extern volatile uint8_t  g_idle_ws_cleared;
+extern volatile uint8_t  g_app_activity;
+extern volatile uint8_t  g_app_idle;
 
 extern volatile uint32_t g_alive_mask, g_triggered_mask;
 extern volatile uint32_t round_alive_mask, round_triggered_mask;
@@ -35,6 +48,21 @@ extern volatile uint32_t round_alive_mask, round_triggered_mask;
 extern volatile uint8_t  g_off_broadcast_pending;
 extern volatile uint8_t  g_off_broadcast2_pending;
 
-void sched_commit_and_clear_poll_round(void);
+void sched_commit_and_clear_poll_round(uint32_t seg_mask);
+
+#if TICKLESS
+void     sched_tickless_init(void);   // after RIT is configured for RIT_TICK_MS
+uint32_t sched_now_tick(void);
+void     sched_wake(void);
+#else
+static inline uint32_t sched_now_tick(void){ return g_tick; }
+static inline void     sched_wake(void){}
+#endif
+
+// App (UART0) activity: stamp for the idle-entry timer, flag for the idle exit
+static inline void sched_app_activity(void){
+    g_app_last_activity_tick = (uint16_t)sched_now_tick();
+    g_app_activity = 1;
+}
 
 #endif /* INC_SCHED_H_ */
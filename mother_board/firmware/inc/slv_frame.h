@@ -0,0 +1,31 @@
+/**
+ * @file slv_frame.h
+ * @brief Receive FSM for the slave-bus frames: SOF | LEN | BODY… | END.
+ *
+ * - One SlvFrameRx per UART (UART1/UART3 slave replies, UART2 BIN acks);
+ *   the ISR feeds every received byte to slv_frame_rx().
+ * - A second SOF right after the first is tolerated (slaves that send a
+ *   doubled SOF), the next byte is then LEN.
+ * - LEN 0 or longer than SLV_FRAME_PAY_MAX drops the frame; so does any
+ *   byte other than END after the body.
+ *
+ * Context: one ISR per parser; no shared state.
+ */
+
+#ifndef INC_SLV_FRAME_H_
+#define INC_SLV_FRAME_H_
+
+#pragma once
+#include <stdint.h>
+
+#define SLV_FRAME_PAY_MAX  8
+
+typedef struct {
+    uint8_t state, len, idx;
+    uint8_t pay[SLV_FRAME_PAY_MAX];
+} SlvFrameRx;
+
+// Feed one byte: body length once a frame ends with END (body in f->pay), else 0
+uint8_t slv_frame_rx(SlvFrameRx *f, uint8_t b);
+
+#endif /* INC_SLV_FRAME_H_ */
@@ -0,0 +1,52 @@
+/**
+ * @file swtimer.h
+ * @brief Software timers on a two-level timing wheel, driven by the RIT tick.
+ *
+ * - SwTimer is intrusive (embed it in the owner's state); no allocation.
+ * - swtimer_start() / swtimer_cancel(): O(1). Restarting a pending timer
+ *   moves it. A callback may start or cancel any timer, its own included,
+ *   also one due in the same tick (it then does not fire).
+ * - Level 0: SWT_SLOTS one-tick slots; level 1: SWT_SLOTS slots of SWT_SLOTS
+ *   ticks, cascaded into level 0 as their block comes up. Delays beyond the
+ *   wheel (SWT_SLOTS² ticks) park in the last level-1 slot and re-cascade.
+ * - swtimer_run(g_tick) is called once per RIT interrupt and fires every
+ *   timer due up to that tick (several ticks at once after a TICKLESS span).
+ * - swtimer_ticks_to_next(): ticks until the next expiry or cascade, for
+ *   TICKLESS to sleep through.
+ *
+ * Context: RIT priority only (RIT itself and the TIMER0 tick domains, which
+ * never preempt each other). Lower-priority ISRs keep time stamps instead
+ * (g_app_last_activity_tick, button debounce) and RIT-side timers look at them.
+ */
+
+#ifndef INC_SWTIMER_H_
+#define INC_SWTIMER_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SWT_BITS   6
+#define SWT_SLOTS  (1u << SWT_BITS)
+
+typedef struct SwTimer SwTimer;
+typedef void (*swtimer_fn)(SwTimer *t);
+
+struct SwTimer {
+    SwTimer   *next;
+    SwTimer  **pprev;     // NULL while not pending
+    uint32_t   expires;   // absolute tick
+    swtimer_fn fn;        // runs in RIT context, timer already unlinked
+};
+
+#define SWTIMER_INIT(f)  { NULL, NULL, 0, (f) }
+
+void     swtimer_start(SwTimer *t, uint32_t ticks);   // fire `ticks` from now (0 = next tick)
+void     swtimer_cancel(SwTimer *t);
+void     swtimer_run(uint32_t now);
+uint32_t swtimer_ticks_to_next(uint32_t limit);      // limit if nothing pending
+
+static inline bool swtimer_pending(const SwTimer *t){ return t->pprev != NULL; }
+
+#endif /* INC_SWTIMER_H_ */
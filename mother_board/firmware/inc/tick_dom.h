@@ -0,0 +1,46 @@
+/**
+ * @file tick_dom.h
+ * @brief Per-activity tick domains on TIMER0 match channels (1 MHz).
+ *
+ * - DOM_SLV (MR0): slave-bus segments, poll / LED frame / transactions.
+ * - DOM_BIN (MR1): one BIN LED frame.
+ * - DOM_WS  (MR2): WS flush request.
+ * - Each channel re-arms itself `period` µs after its last match, so every
+ *   domain keeps its own cadence; RIT (g_tick) stays the time base for job
+ *   deadlines, the job mailbox and the idle watchdog.
+ * - TIMER0 runs at IRQ_PRIO_RIT: a domain and RIT never preempt each other,
+ *   so the job tables still see one writer at a time.
+ * - Periods (ms) change at run time via tick_dom_set_period() (SC_TICK_PERIODS);
+ *   they are clamped to DOM_SLV_MIN_MS / DOM_MIN_MS.
+ *
+ * TICK_DOMAINS=0: no timer; RIT runs the domain bodies every tick.
+ */
+
+#ifndef INC_TICK_DOM_H_
+#define INC_TICK_DOM_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+typedef enum { DOM_SLV = 0, DOM_BIN, DOM_WS, DOM_COUNT } tick_dom_t;
+
+extern volatile uint8_t g_dom_period_ms[DOM_COUNT];
+
+void tick_dom_init(void);
+bool tick_dom_set_period(uint8_t dom, uint8_t ms);   // 0 = keep; false if out of range
+// TICKLESS: stop TIMER0 for a long RIT span / restart every channel one period from now
+void tick_dom_suspend(void);
+void tick_dom_resume(void);
+void TIMER0_IRQHandler(void);
+
+static inline uint8_t tick_dom_period_ms(uint8_t dom){
+#if TICK_DOMAINS
+    return g_dom_period_ms[dom];
+#else
+    (void)dom; return RIT_TICK_MS;
+#endif
+}
+
+#endif /* INC_TICK_DOM_H_ */
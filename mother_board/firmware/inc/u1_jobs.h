@@ -1,17 +1,33 @@
 /**
  * @file u1_jobs.h
- * @brief UART1 LED "streaming" job table and round-robin scheduler.
+ * @brief Slave-bus LED "streaming" job table and per-segment round-robin scheduler.
  *
- * - U1Job: (con, led, next_allowed_tick, active).
- * - De-dup / reset-on-new helpers:
- *     u1_jobs_remove_by_con_except(), u1_job_find(), u1_job_alloc(), u1_jobs_clear_all()
- * - u1_scheduler_emit_one(): called from RIT to enqueue exactly one LED-ON
- *   frame if timing allows; advances RR pointer.
+ * - g_u1_jobs[] is indexed directly by connector (1..31): reset-on-new keeps
+ *   one job per connector, so a slot is (led, flags, period, deadline) and the
+ *   active set is the bitmap g_u1_active (CONN_BIT(con) per job).
+ * - De-dup / reset-on-new helpers (all O(1)):
+ *     u1_jobs_remove_by_con_except(), u1_job_find(), u1_job_start(), u1_jobs_clear_all()
+ *   find/start return the slot index (= con) or 0xFF.
+ * - Per-job refresh period and priority come from the LEDF_* flags of LED_CTRL
+ *   (led_job_period()): default LED_KEEPALIVE_TICKS, LEDF_SLOW, LEDF_ONESHOT
+ *   (send once, then retire), LEDF_URGENT (deadline LED_URGENT_LEAD_TICKS early).
+ * - Multicast job (g_u1_multi): one LED number for a bitmap of connectors,
+ *   emitted as one SLV_SUB_LED_MULTI frame per segment (members of that
+ *   segment only). It is checked before the per-connector jobs.
+ * - u1_scheduler_emit_one(seg): called from RIT once per slave-bus segment to
+ *   enqueue at most one LED-ON frame for that segment's connectors, picked
+ *   earliest-deadline-first among the due jobs. A start makes the job due now;
+ *   after a send it waits on its own software timer (swtimer.h) for its refresh
+ *   period (or LED_ACK_TIMEOUT_TICKS while LED_ACK_MODE has no confirmation in
+ *   g_u1_ack_led[]) and becomes due when it expires, so no tick scans idle jobs.
+ *   Change-only: a job whose LED equals the shadow of the last frame sent (see
+ *   led_shadow.h) is re-armed without a frame.
  *
  * Contract:
- * - RIT decides whether to stream or to poll; when streaming is active the RR
- *   over jobs runs; otherwise poller runs.
- * - ISRs may adjust jobs with NVIC masking where needed (callers ensure safety).
+ * - RIT decides whether to stream or to poll; a segment with a due job
+ *   streams, otherwise its poller runs.
+ * - Only RIT writes the tables; App handlers post operations through
+ *   job_mbox.h, applied at the start of each tick.
  */
 
 #ifndef INC_U1_JOBS_H_
@@ -23,22 +39,43 @@
 #include "config.h"
 
 typedef struct {
-    uint8_t  con, led;
-    uint16_t next_allowed_tick;
-    volatile uint8_t active;
+    uint8_t  led;
+    uint8_t  flags;              // LEDF_*
+    uint16_t period;             // refresh period in ticks, 0 = never
+    uint16_t deadline;           // tick the next frame is due (EDF lateness)
 } U1Job;
 
+typedef struct {
+    uint32_t mask;               // CONN_BIT(con) per member, 0 = inactive
+    uint8_t  led;
+} U1MultiJob;
+
 extern volatile U1Job  g_u1_jobs[MAX_U1_JOBS];
+extern volatile uint32_t g_u1_active;          // CONN_BIT(con) per active job
+extern volatile U1MultiJob g_u1_multi;
 extern volatile bool   g_led_streaming_active;
-extern uint8_t         u1_jobs_rr;
 
 void    u1_jobs_clear_all(void);
 void    u1_jobs_remove_by_con_except(uint8_t con, uint8_t keep_led);
 uint8_t u1_job_find(uint8_t con, uint8_t led);
-uint8_t u1_job_alloc(uint8_t con, uint8_t led);
+// Start or refresh the job for con (call u1_jobs_remove_by_con_except first); due now
+uint8_t u1_job_start(uint8_t con, uint8_t led, uint8_t flags);
+
+// Add connectors to the multicast job; a different LED replaces the old member set
+void    u1_multi_add(uint32_t mask, uint8_t led);
+
+#if LED_ACK_MODE
+// LED each slave reported in its last status reply (UART1 RX writes, RIT reads)
+extern volatile uint8_t g_u1_ack_led[32];
+#endif
+
+// Slave LED state unknown (after an OFF broadcast): resend every job once
+void    u1_shadow_invalidate_all(void);
 
-// Called from RIT: enqueues one LED frame if time_ok, advances RR
-bool    u1_scheduler_emit_one(void);
+// Called from RIT per segment: enqueues the earliest-deadline due LED frame, if any
+bool    u1_scheduler_emit_one(uint8_t seg);
+// Any per-connector job due now (TICKLESS: keep ticking)
+bool    u1_jobs_due_any(void);
 
 
 #endif /* INC_U1_JOBS_H_ */
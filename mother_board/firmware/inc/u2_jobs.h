@@ -2,15 +2,23 @@
  * @file u2_jobs.h
  * @brief UART2 (BIN) LED streaming jobs and helpers (including multi-mask).
  *
- * - U2Job: (bin, led, next_allowed_tick, active).
- * - Start/stop/de-dup helpers for per-LED streaming.
- * - u2_scheduler_emit_one(): RIT emits one BIN LED-ON per tick if due.
+ * - g_u2_jobs[] is indexed directly by BIN id (1..MAX_BIN), one job per BIN;
+ *   the active set is the bitmap g_u2_active (bit bin-1).
+ * - Start/stop/de-dup helpers for per-LED streaming (O(1) except stop_by_led,
+ *   which walks the active bits only). u2_job_start() takes the LEDF_* flags
+ *   of LED_CTRL: per-job refresh period (led_job_period()) and priority.
+ * - u2_scheduler_emit_one(): RIT emits one BIN LED-ON per tick, earliest
+ *   deadline first among the due jobs (software timers, same rules as u1_jobs.h). Change-only per BIN id
+ *   (led_shadow.h): a job goes on the wire when its LED differs from the last
+ *   one sent, or when its refresh period expires. LED_ACK_MODE: unconfirmed
+ *   frames (g_u2_ack_led[], fed by UART2 RX) are resent after LED_ACK_TIMEOUT_TICKS.
  * - Frame helpers:
  *     bin_enqueue_led_on_uart2(), bin_enqueue_led_off_broadcast_uart2(),
  *     bin_enqueue_multi_mask_uart2() for compact batch updates.
  *
  * Threading:
  * - Push to the UART2 TX queue is ISR-safe; actual TX occurs in main loop.
+ * - Job table ops run in RIT only (App handlers go through job_mbox.h).
  */
 
 #ifndef INC_U2_JOBS_H_
@@ -21,21 +29,31 @@
 #include <stdbool.h>
 #include "config.h"
 
-typedef struct { uint8_t bin, led; uint16_t next_allowed_tick; volatile uint8_t active; } U2Job;
+typedef struct { uint8_t led, flags; uint16_t period, deadline; } U2Job;   // see U1Job
 
-extern volatile U2Job g_u2_jobs[MAX_U2_JOBS];
-extern uint8_t       u2_jobs_rr;
+extern volatile U2Job    g_u2_jobs[MAX_U2_JOBS];
+extern volatile uint32_t g_u2_active;   // bit (bin-1) per active job
 
-void    u2_job_start(uint8_t bin, uint8_t led);
+// Start or refresh the job for bin (call u2_jobs_remove_by_bin_except first); due now
+uint8_t u2_job_start(uint8_t bin, uint8_t led, uint8_t flags);
 void    u2_jobs_stop_by_led(uint8_t led);
 void    u2_jobs_stop_all(void);
 void    u2_jobs_remove_by_bin_except(uint8_t bin, uint8_t keep_led);
 uint8_t u2_job_find(uint8_t bin, uint8_t led);
 
-// Called from RIT: enqueues one BIN frame if time_ok, advances RR
+#if LED_ACK_MODE
+// Normalized LED each BIN reported in its last status reply (UART2 RX writes)
+extern volatile uint8_t g_u2_ack_led[MAX_BIN + 1];
+#endif
+
+// BIN LED state unknown (OFF broadcast / mask frame): resend every job once
+void    u2_shadow_invalidate_all(void);
+
+// Called from RIT: enqueues the earliest-deadline due BIN frame, if any
 bool    u2_scheduler_emit_one(void);
+bool    u2_jobs_due_any(void);
 
-// Frame helpers used by ISR/RIT
+// Frame helpers, RIT only (the UART2 ring has a single producer)
 void bin_enqueue_led_on_uart2(uint8_t bin, uint8_t led);
 void bin_enqueue_led_off_broadcast_uart2(void);
 void bin_enqueue_multi_mask_uart2(uint8_t max_led, const uint8_t *list);
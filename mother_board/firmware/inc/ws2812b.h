@@ -27,16 +27,18 @@ typedef struct {
 } RGB_t;
 
 /**
- * @brief LED mask to set and clear P3[25] an P3[26]
+ * @brief Per-strip data pins (P3[25], P3[26]) and the mask of both
  */
-#define LED_MASK   ((1U << 25) | (1U << 26))
+#define LED_PIN_STRIP1  (1U << 25)
+#define LED_PIN_STRIP2  (1U << 26)
+#define LED_MASK   (LED_PIN_STRIP1 | LED_PIN_STRIP2)
 
 /**
  * @brief WS2812B LED strip object.
  */
 typedef struct {
     RGB_t* leds;     /**< Pointer to LED color buffer */
-    uint8_t num_leds;/**< Number of LEDs in the strip */
+    uint16_t num_leds;/**< Number of LEDs in the strip */
 } WS2812B;
 
 /*------------------------------------------------------------------------------
@@ -50,6 +52,25 @@ typedef struct {
  */
 void WS2812B_write(WS2812B* ws2812b);
 
+/**
+ * @brief Write several strips on P3 in one pass, one buffer per lane.
+ *
+ * Every lane goes high together; lanes sending '0' drop at T0H, the rest at
+ * T1H, so N strips take the time of one. Buffers hold palette indices, `bits`
+ * per LED packed into words (LED 0 in the low bits), expanded through `pal`
+ * while the previous LED's last bit is low.
+ *
+ * @param fb        Per-lane index buffers (num_leds each).
+ * @param bits      Bits per LED (2 or 4).
+ * @param pal       Palette, 1 << bits entries.
+ * @param pin_masks Per-lane GPIO3 pin mask.
+ * @param lanes     Number of lanes (1..WS2812B_MAX_LANES).
+ * @param num_leds  LEDs per lane.
+ */
+#define WS2812B_MAX_LANES  4
+void WS2812B_write_lanes(const uint32_t *const *fb, uint8_t bits, const RGB_t *pal,
+                         const uint32_t *pin_masks, uint8_t lanes, uint16_t num_leds);
+
 /**
  * @brief Set a given LED to RED (R=255, G=0, B=0).
  *
@@ -0,0 +1,85 @@
+/**
+ * @file ws_hw.h
+ * @brief WS2812 output backend (WS_BACKEND), used only by ws_led.c.
+ *
+ * - One lane per strip (WS_STRIPS), each with its own palette-indexed buffer
+ *   (ws_pal.h); indices are expanded to RGB as they are encoded.
+ * - WS_BACKEND_BITBANG: DWT-timed GPIO, lane 0 on P3.25, lane 1 on P3.26
+ *   (ws2812b.c), both lanes in one pass. Interrupts are masked for the frame
+ *   (~3.6 ms per 120 LEDs, whatever the lane count); ws_hw_write() returns
+ *   when the frame is out.
+ * - WS_BACKEND_SSP_DMA: lane 0 on SSP0 MOSI (P0.18), lane 1 on SSP1 MOSI
+ *   (P0.9). Every WS bit becomes a 3-bit SPI symbol (100 = 0, 110 = 1) at
+ *   2.5 MHz, streamed by one GPDMA channel per lane. ws_hw_write() encodes
+ *   the frame and starts the transfers; interrupts stay enabled.
+ * - WS_BACKEND_TIMER_DMA: both lanes on P3.25/P3.26 as with bit-bang, but
+ *   three GPDMA channels write the port-3 SET/CLR registers on TIMER2/TIMER3
+ *   match events (bit start, T0H, T1H). ws_hw_write() builds one CLR byte
+ *   per WS bit and starts the timers; interrupts stay enabled.
+ *
+ * WS_DMA_STREAM (long strips): instead of a pre-encoded frame, the DMA
+ * backends encode WS_DMA_CHUNK_LEDS at a time from `lanes` into two ping-pong
+ * buffers, refilled from DMA_IRQHandler (IRQ_PRIO_WS_DMA) while the other one
+ * is sent. `lanes` must stay unchanged until ws_hw_busy() is false.
+ *
+ * Callers check ws_hw_busy() before writing again (a DMA frame may still be
+ * on the wire). Main-loop / WS-task context only.
+ */
+
+#ifndef INC_WS_HW_H_
+#define INC_WS_HW_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "ws2812b.h"
+
+/* GPDMA masters reach the AHB SRAM banks but not the local SRAM at 0x10000000:
+   every buffer a DMA channel reads goes in the AHB bank (MCUXpresso RAM2). */
+#define WS_DMA_RAM  __attribute__((section(".bss.$RAM2")))
+
+void ws_hw_init(void);
+bool ws_hw_busy(void);
+// DMA backends keep an encoded stream; ws_led.c updates it per changed pixel
+// while publishing a frame, never during a transfer (no-op for bit-bang)
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c);
+// Bit-bang and WS_DMA_STREAM encode `lanes` (WS_STRIPS ws_pal.h buffers); otherwise the DMA stream is sent
+void ws_hw_write(const uint32_t *const *lanes, uint16_t n);
+
+#if WS_BACKEND != WS_BACKEND_BITBANG
+#include "chip.h"
+
+/* Start an M2P channel by register. LPCOpen's helpers map the destination
+   through their peripheral table, so they can neither target GPIO nor chain
+   a descriptor (`lli`, hardware LLI layout, in WS_DMA_RAM) behind the first.
+   `irq`: terminal-count interrupts for descriptors with GPDMA_DMACCxControl_I. */
+static inline void ws_dma_start(uint8_t ch, uint32_t src, uint32_t dst, uint32_t ctrl,
+                                const DMA_TransferDescriptor_t *lli, uint8_t req, bool irq){
+    GPDMA_CH_T * const c = &LPC_GPDMA->CH[ch];
+    LPC_GPDMA->INTTCCLEAR = 1u << ch;
+    LPC_GPDMA->INTERRCLR  = 1u << ch;
+    c->SRCADDR  = src;
+    c->DESTADDR = dst;
+    c->LLI      = (uint32_t)(uintptr_t)lli;
+    c->CONTROL  = ctrl;
+    c->CONFIG   = GPDMA_DMACCxConfig_E | GPDMA_DMACCxConfig_DestPeripheral(req)
+                | GPDMA_DMACCxConfig_TransferType(GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA)
+                | (irq ? GPDMA_DMACCxConfig_ITC : 0u);
+}
+
+#if WS_DMA_STREAM
+void DMA_IRQHandler(void);
+
+/* Chunk j of a streamed frame: LEDs [j * WS_DMA_CHUNK_LEDS, +len) of n */
+static inline uint16_t ws_chunk_len(uint16_t j, uint16_t n){
+    const uint32_t first = (uint32_t)j * WS_DMA_CHUNK_LEDS;
+    return (uint16_t)((n - first < WS_DMA_CHUNK_LEDS) ? n - first : WS_DMA_CHUNK_LEDS);
+}
+static inline uint16_t ws_chunks(uint16_t n){
+    return (uint16_t)((n + WS_DMA_CHUNK_LEDS - 1u) / WS_DMA_CHUNK_LEDS);
+}
+#endif
+#endif
+
+#endif /* INC_WS_HW_H_ */
@@ -1,14 +1,20 @@
 /**
  * @file ws_led.h
- * @brief WS2812 (NeoPixel) framebuffer + flush control (no ISR writes).
+ * @brief WS2812 (NeoPixel) framebuffer + flush control.
  *
- * - In-memory RGB buffer for WS strip(s).
- * - High-level ops: clear all, set one LED, set "only bin1" LED,
- *                   set a mask list and clear others.
+ * - One palette-indexed buffer per WS strip (WS_STRIPS, ws_pal.h) of up to
+ *   65535 LEDs. WS_SEGMENTS maps BIN LEDs onto strip ranges: a strip may
+ *   mirror one BIN or carry several end to end, and strips can differ.
+ * - High-level ops: clear all, set one LED, set "only this BIN LED",
+ *                   set a mask list (BIN 1 strips) and clear others.
+ * - Effects: WS_FX_MAX slots, each blinking / pulsing / chasing an LED
+ *   range on the segments of one BIN. ws_fx_tick() advances them from the WS
+ *   tick domain; a slot runs until replaced, stopped or ws_clear_all().
  * - Flush is *requested* (cheap) from anywhere; actual I/O happens in main.
  *
- * Threading: Functions are non-blocking; hardware write occurs via
- * ws_flush_if_pending() in the main loop to keep ISRs short.
+ * Threading: the set/clear functions are non-blocking and may run in any ISR;
+ * they write a back buffer only. ws_flush_if_pending() (main loop / WS task)
+ * copies it into the front buffer the hardware reads, then writes.
  */
 
 #ifndef INC_WS_LED_H_
@@ -16,6 +22,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 #include "config.h"
 
 // Initialize (optional clear)
@@ -23,9 +30,19 @@ void ws_init(void);
 
 // Set/clear pixel buffer; flushing is requested then performed in main
 void ws_clear_all(void);
-void ws_set_red_1indexed(uint16_t led1);
-void ws_set_only_bin1(uint16_t led1);
-void ws_set_mask_bin1_and_clear_others(uint8_t max_led, const uint8_t *list);
+void ws_set_red_1indexed(uint8_t strip, uint16_t led1);
+void ws_set_only_bin(uint8_t bin, uint16_t led1);   // segments mirroring `bin`; no-op if none
+void ws_set_mask_bin1_and_clear_others(uint8_t max_led, const uint8_t *list);   // BIN 1 segments
+
+// Effects (SC_WS_EFFECT). blink: arg = duty %; pulse: brightness ramps up and
+// down once per period (dithered per WS tick, any palette); chase: arg = 8-LED
+// on/off pattern, shifted one LED per period.
+enum { WS_FX_NONE = 0, WS_FX_BLINK, WS_FX_PULSE, WS_FX_CHASE };
+bool ws_fx_set(uint8_t slot, uint8_t kind, uint8_t bin, uint16_t led1, uint16_t count,
+               uint8_t colour, uint16_t period_ms, uint8_t arg);   // kind NONE stops the slot
+void ws_fx_stop_all(void);
+void ws_fx_tick(uint16_t ms);   // WS tick domain
+bool ws_fx_active(void);
 
 void ws_request_flush(void);
 void ws_flush_if_pending(void);
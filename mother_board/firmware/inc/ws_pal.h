@@ -0,0 +1,65 @@
+/**
+ * @file ws_pal.h
+ * @brief Palette-indexed WS2812 framebuffer: WS_PAL_BITS per LED.
+ *
+ * - Each LED holds a palette index (2 bits: 4 colours, 4 bits: 16), packed
+ *   into 32-bit words, LED 0 in the low bits. 120 LEDs take 32 bytes (2 bits)
+ *   or 60 bytes (4 bits) instead of 360.
+ * - The palette is a compile-time table with WS_BRIGHTNESS and a ~2.2 gamma
+ *   already applied; backends expand an index to RGB_t as they encode.
+ * - ws_pal_put() is LDREX/STREX: neighbouring LEDs share a word and may be
+ *   written from ISRs of different priority.
+ */
+
+#ifndef INC_WS_PAL_H_
+#define INC_WS_PAL_H_
+
+#pragma once
+#include <stdint.h>
+#include "config.h"
+#include "ws2812b.h"
+#include "bitband.h"
+
+#if WS_PAL_BITS != 2 && WS_PAL_BITS != 4
+#error "WS_PAL_BITS must be 2 or 4"
+#endif
+
+#define WS_PAL_SIZE       (1u << WS_PAL_BITS)
+#define WS_PAL_PER_WORD   (32u / WS_PAL_BITS)
+#define WS_PAL_WORDS(n)   (((n) + WS_PAL_PER_WORD - 1u) / WS_PAL_PER_WORD)
+
+enum {
+    WS_PAL_OFF = 0, WS_PAL_RED, WS_PAL_GREEN, WS_PAL_BLUE,
+#if WS_PAL_BITS == 4
+    WS_PAL_YELLOW, WS_PAL_CYAN, WS_PAL_MAGENTA, WS_PAL_WHITE,
+    WS_PAL_ORANGE, WS_PAL_PURPLE, WS_PAL_DIM_RED, WS_PAL_DIM_GREEN,
+    WS_PAL_DIM_BLUE, WS_PAL_DIM_WHITE, WS_PAL_AMBER, WS_PAL_PINK,
+#endif
+};
+
+extern const RGB_t g_ws_pal[WS_PAL_SIZE];
+
+// Dimmer entry of the same hue (pulse ramp midpoint); itself if the palette has none
+static inline uint8_t ws_pal_dim(uint8_t c){
+#if WS_PAL_BITS == 4
+    switch (c){
+        case WS_PAL_RED:   return WS_PAL_DIM_RED;
+        case WS_PAL_GREEN: return WS_PAL_DIM_GREEN;
+        case WS_PAL_BLUE:  return WS_PAL_DIM_BLUE;
+        case WS_PAL_WHITE: return WS_PAL_DIM_WHITE;
+        default: break;
+    }
+#endif
+    return c;
+}
+
+static inline uint8_t ws_pal_get(const volatile uint32_t *fb, uint16_t i){
+    return (uint8_t)((fb[i / WS_PAL_PER_WORD] >> ((i % WS_PAL_PER_WORD) * WS_PAL_BITS)) & (WS_PAL_SIZE - 1u));
+}
+
+static inline void ws_pal_put(volatile uint32_t *fb, uint16_t i, uint8_t c){
+    const uint8_t sh = (uint8_t)((i % WS_PAL_PER_WORD) * WS_PAL_BITS);
+    mask_assign(&fb[i / WS_PAL_PER_WORD], (WS_PAL_SIZE - 1u) << sh, (uint32_t)c << sh);
+}
+
+#endif /* INC_WS_PAL_H_ */
@@ -0,0 +1,92 @@
+/**
+ * @file xact.h
+ * @brief Stackless (protothread) transactions on the slave and BIN buses: send, await reply, retry.
+ *
+ * - A transaction is a body function resumed once per RIT tick. It keeps its
+ *   place in `lc` (switch/__LINE__ continuation), so locals do not survive a
+ *   wait: keep state in the Xact (or behind `ctx`).
+ * - A bus is a slave segment (0..SLV_SEGS-1) or XACT_BUS_BIN (UART2).
+ * - One transaction owns a bus at a time; while it does, slave_seg_tick() /
+ *   dom_bin_tick() send no LED frames or polls there, so its reply cannot be
+ *   confused. Transactions on different buses run side by side; more on the
+ *   same bus queue in start order.
+ * - Replies: the slave and BIN RX paths offer every frame to xact_rx(); it is
+ *   taken when SC (pay[0]) and address (pay[1]) match the pending XACT_AWAIT_REPLY.
+ * - In use: LED_ACK_MODE sends each per-target LED-ON as an xact_request()
+ *   (u1_jobs.c, u2_jobs.c); an OFF broadcast cancels the bus's transactions.
+ * - Start/run/cancel from RIT context only (e.g. from job_mbox_apply_all());
+ *   xact_rx() is the only entry from the RX ISRs.
+ *
+ * Body skeleton:
+ *   static uint8_t my_body(Xact *x){
+ *       XACT_BEGIN(x);
+ *       xact_send(x, frame, n);
+ *       XACT_AWAIT_REPLY(x, SC_STATUS, addr, XACT_TIMEOUT_TICKS);
+ *       if (!xact_replied(x)) return XACT_FAILED;
+ *       ...
+ *       XACT_END(x);
+ *   }
+ */
+
+#ifndef INC_XACT_H_
+#define INC_XACT_H_
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+enum { XACT_WAITING = 0, XACT_DONE, XACT_FAILED };
+
+#define XACT_BUS_BIN   SLV_SEGS          // UART2 BIN bus, after the slave segments
+#define XACT_BUSES     (SLV_SEGS + 1)
+
+typedef struct Xact Xact;
+typedef uint8_t (*xact_fn)(Xact *x);                       // body: XACT_WAITING / DONE / FAILED
+typedef void    (*xact_done_fn)(Xact *x, uint8_t result);  // RIT context, slot freed afterwards
+
+struct Xact {
+    uint16_t     lc;                 // continuation (0 = start)
+    uint8_t      state, seg;
+    uint8_t      gen;                // bumped per start: stale replies are ignored
+    volatile uint8_t rx_gen;         // == gen once a reply has been stored (set last by RX ISR)
+    uint8_t      want_sc, want_addr;
+    uint32_t     deadline;
+    uint8_t      rx[8], rx_len;
+    uint8_t      tx[12], tx_len;     // xact_request(): frame, reply SC/address, retry budget
+    uint8_t      req_sc, req_addr;
+    uint8_t      tries, retries, timeout;
+    xact_fn      body;
+    xact_done_fn done;
+    void        *ctx;
+};
+
+// Protothread macros (no `switch` of your own around a wait)
+#define XACT_BEGIN(x)            switch ((x)->lc) { case 0:
+#define XACT_END(x)              } (x)->lc = 0; return XACT_DONE
+#define XACT_WAIT_UNTIL(x, c)    do { (x)->lc = (uint16_t)__LINE__; /* fall through */ case __LINE__: \
+                                      if (!(c)) return XACT_WAITING; } while (0)
+#define XACT_AWAIT_REPLY(x, sc, addr, ticks) \
+    do { xact_expect((x), (sc), (addr), (ticks)); \
+         XACT_WAIT_UNTIL((x), xact_replied(x) || xact_timed_out(x)); } while (0)
+
+// Start a body on bus `seg`; returns the slot, 0xFF if the pool is full
+uint8_t xact_start(uint8_t seg, xact_fn body, xact_done_fn done, void *ctx);
+// Send `frame` to `addr`, retry up to `retries` times until SC `want_sc` comes back
+uint8_t xact_request(uint8_t seg, const uint8_t *frame, uint8_t n, uint8_t want_sc, uint8_t addr,
+                     uint8_t retries, xact_done_fn done, void *ctx);
+void    xact_cancel_seg(uint8_t seg);
+bool    xact_busy(void);               // any transaction started and not finished
+
+// RIT: advance the transaction owning `seg`; true while the bus is held
+bool    xact_run(uint8_t seg);
+// Slave / BIN RX ISRs: offer a reply body; true if a transaction took it
+bool    xact_rx(uint8_t seg, const uint8_t *pay, uint8_t len);
+
+// Body helpers
+bool    xact_send(Xact *x, const uint8_t *frame, uint8_t n);
+void    xact_expect(Xact *x, uint8_t sc, uint8_t addr, uint8_t ticks);
+bool    xact_timed_out(const Xact *x);
+static inline bool xact_replied(const Xact *x){ return x->rx_gen == x->gen; }
+
+#endif /* INC_XACT_H_ */
@@ -0,0 +1,149 @@
+/*
+ * app_io.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "chip.h"
+#include "board.h"
+
+#include "config.h"
+#include "proto.h"
+#include "queues.h"
+#include "ws_led.h"
+#include "app_status.h"
+#include "sched.h"
+#include "isr_uart1.h"
+#include "app_io.h"
+#include "tick_dom.h"
+
+// UART macro aliases for readability (same as original)
+#define UART_APP   LPC_UART0
+#define UART_SLAVE LPC_UART1
+#define UART_BIN   LPC_UART2
+#define UART_SLAVE2 LPC_UART3
+
+// Slave-bus segment -> UART (see SLV_SEGS)
+static LPC_USART_T* const s_slv_uart[SLV_SEGS] = {
+    UART_SLAVE,
+#if SLV_SEGS > 1
+    UART_SLAVE2,
+#endif
+};
+
+void app_io_init(void){
+    SystemCoreClockUpdate();
+    Board_Init();
+
+    NVIC_ClearPendingIRQ(EINT3_IRQn);
+    NVIC_SetPriority(EINT3_IRQn, IRQ_PRIO_SLV);
+    NVIC_EnableIRQ(EINT3_IRQn);
+
+    // UART0: App
+    Chip_UART_Init(UART_APP);
+    Chip_UART_SetBaud(UART_APP, 19200);
+    Chip_UART_ConfigData(UART_APP, UART_LCR_WLEN8 | UART_LCR_SBS_1BIT);
+    Chip_UART_SetupFIFOS(UART_APP, UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2);
+    Chip_UART_TXEnable(UART_APP);
+
+    // UART1: Slaves
+    Chip_UART_Init(UART_SLAVE);
+    Chip_UART_SetBaud(UART_SLAVE, 9600);
+    Chip_UART_ConfigData(UART_SLAVE, UART_LCR_WLEN8 | UART_LCR_SBS_1BIT);
+    Chip_UART_SetupFIFOS(UART_SLAVE, UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2);
+    Chip_UART_TXEnable(UART_SLAVE);
+
+#if SLV_SEGS > 1
+    // UART3: Slaves, segment 1
+    Chip_UART_Init(UART_SLAVE2);
+    Chip_UART_SetBaud(UART_SLAVE2, 9600);
+    Chip_UART_ConfigData(UART_SLAVE2, UART_LCR_WLEN8 | UART_LCR_SBS_1BIT);
+    Chip_UART_SetupFIFOS(UART_SLAVE2, UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2);
+    Chip_UART_TXEnable(UART_SLAVE2);
+#endif
+
+    // UART2: BIN
+    Chip_UART_Init(UART_BIN);
+    Chip_UART_SetBaud(UART_BIN, 9600);
+    Chip_UART_ConfigData(UART_BIN, UART_LCR_WLEN8 | UART_LCR_SBS_1BIT);
+    Chip_UART_SetupFIFOS(UART_BIN, UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2);
+    Chip_UART_TXEnable(UART_BIN);
+
+    // UART IRQs
+    Chip_UART_IntEnable(UART_APP,   UART_IER_RBRINT | UART_IER_RLSINT);
+    NVIC_SetPriority(UART0_IRQn, IRQ_PRIO_APP); NVIC_EnableIRQ(UART0_IRQn);
+
+    Chip_UART_IntEnable(UART_SLAVE, UART_IER_RBRINT | UART_IER_RLSINT);
+    NVIC_SetPriority(UART1_IRQn, IRQ_PRIO_SLV); NVIC_EnableIRQ(UART1_IRQn);
+#if SLV_SEGS > 1
+    Chip_UART_IntEnable(UART_SLAVE2, UART_IER_RBRINT | UART_IER_RLSINT);
+    NVIC_SetPriority(UART3_IRQn, IRQ_PRIO_SLV); NVIC_EnableIRQ(UART3_IRQn);
+#endif
+
+#if LED_ACK_MODE
+    // UART2 RX only carries LED confirmations from the BIN slaves
+    Chip_UART_IntEnable(UART_BIN,   UART_IER_RBRINT | UART_IER_RLSINT);
+    NVIC_SetPriority(UART2_IRQn, IRQ_PRIO_SLV); NVIC_EnableIRQ(UART2_IRQn);
+#endif
+
+    // RIT (70 ms)
+    Chip_RIT_Init(LPC_RITIMER);
+    Chip_RIT_SetTimerInterval(LPC_RITIMER, RIT_TICK_MS);
+    NVIC_ClearPendingIRQ(RITIMER_IRQn);
+    NVIC_SetPriority(RITIMER_IRQn, IRQ_PRIO_RIT);
+    NVIC_EnableIRQ(RITIMER_IRQn);
+#if TICKLESS
+    sched_tickless_init();
+#endif
+
+    // TIMER0: slave / BIN / WS tick domains (TICK_DOMAINS)
+    tick_dom_init();
+
+    // DWT cycle counter: fine timebase (TDMA reply slots, FreeRTOS run-time stats)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // WS
+    ws_init();
+}
+
+// Send prepared App status (if any)
+bool app_io_service_app_tx(void){
+    size_t n = app_status_peek_len();
+    if (!n) return false;
+    const uint8_t* p = app_status_peek_buf();
+    Chip_UART_SendBlocking(UART_APP, p, (int)n);
+    app_status_mark_sent();
+    sched_app_activity();
+    return true;
+}
+
+bool app_io_service_slave_tx(uint8_t seg){
+    U1Frame fr1;
+    if (seg >= SLV_SEGS) return false;
+#if U1_POLL_TDMA
+    // Before the pop: a queued broadcast always belongs to the latest round
+    // (RIT only arms one on an empty queue)
+    const uint32_t round = u1_tdma_round(seg);
+#endif
+    if (!slvq_pop_main(seg, &fr1)) return false;
+    LPC_USART_T* const u = s_slv_uart[seg];
+    Chip_UART_SendBlocking(u, fr1.data, fr1.len);
+#if U1_POLL_TDMA
+    if (fr1.data[4] == SLV_ADDR_BROADCAST && fr1.data[5] == SLV_SUB_POLL_ALL){
+        // Reply slots are timed from the END byte leaving the shifter
+        while (!(Chip_UART_ReadLineStatus(u) & UART_LSR_TEMT)) {}
+        u1_tdma_window_open(seg, round);
+    }
+#endif
+    return true;
+}
+
+bool app_io_service_bin_tx(void){
+    U2Frame fr2;
+    if (!u2q_pop_main(&fr2)) return false;
+    Chip_UART_SendBlocking(UART_BIN, fr2.data, fr2.len);
+    return true;
+}
@@ -7,14 +7,21 @@
 
 #include "app_status.h"
 #include "proto.h"
+#include "bitband.h"
+#include "app_wake.h"
 
 volatile uint8_t  g_status_ext = 0x00;
 volatile uint32_t g_status01_mask = 0;
-volatile uint32_t g_force01_while_triggered_mask = 0;
+BITBAND_RAM volatile uint32_t g_force01_while_triggered_mask;   // UART0/GPIO clear bits, UART0 sets
 
 uint8_t  cfg_conn[MAX_CFG];
 uint8_t  cfg_count = 0;
 
+uint8_t  cfg_seg_conn[SLV_SEGS][MAX_CFG];
+uint8_t  cfg_seg_count[SLV_SEGS];
+uint8_t  g_con_seg[32];
+uint32_t g_seg_conn_mask[SLV_SEGS] = { 0xFFFFFFFFu };
+
 // Prepared status buffer (sent by main)
 static volatile uint8_t g_tx_len = 0;
 static uint8_t          g_tx_buf[TX_FRAME_MAX];
@@ -29,8 +36,10 @@ static uint8_t build_status_frame(uint8_t *dst, uint8_t cap){
     const uint8_t TOT = (uint8_t)(LEN + 3);
     if (TOT > cap) return 0;
 
-    const uint32_t view_alive = (g_alive_mask | round_alive_mask);
-    const uint32_t view_trig  = ((g_triggered_mask | round_triggered_mask) & view_alive);
+    // round_* first: a commit in between moves bits round → g_*, never the other way
+    const uint32_t round_alive = round_alive_mask, round_trig = round_triggered_mask;
+    const uint32_t view_alive = (g_alive_mask | round_alive);
+    const uint32_t view_trig  = ((g_triggered_mask | round_trig) & view_alive);
 
     uint8_t *p = dst;
     *p++=SOF; *p++=LEN; *p++=GRP_RX_TO_APP; *p++=RX_ID; *p++=SC_STATUS;
@@ -50,7 +59,7 @@ static uint8_t build_status_frame(uint8_t *dst, uint8_t cap){
             if (trig) {
                 Si = 0x01;
             } else {
-                g_force01_while_triggered_mask &= ~b;
+                bb_clr(&g_force01_while_triggered_mask, (uint8_t)(c - 1));
                 Si = alive ? 0x05 : 0x00;
             }
         } else {
@@ -64,13 +73,26 @@ static uint8_t build_status_frame(uint8_t *dst, uint8_t cap){
 
 void request_status_reply(void){
     g_tx_len = build_status_frame(g_tx_buf, sizeof g_tx_buf);
-    if (g_tx_len) g_status01_mask = 0; // one-shot cleared after preparing
+    if (g_tx_len){
+        g_status01_mask = 0; // one-shot cleared after preparing
+        app_wake_from_isr(WAKE_APP_TX);
+    }
 }
 
 size_t app_status_peek_len(void){ return g_tx_len; }
 const uint8_t* app_status_peek_buf(void){ return g_tx_buf; }
 void app_status_mark_sent(void){ g_tx_len = 0; }
 
+// Split cfg_conn[] into the per-segment poll lists by g_con_seg[]
+static void seg_lists_rebuild(void){
+    for (uint8_t g=0; g<SLV_SEGS; ++g){ cfg_seg_count[g] = 0; g_seg_conn_mask[g] = 0; }
+    for (uint8_t i=0; i<cfg_count; ++i){
+        const uint8_t c = cfg_conn[i], seg = con_seg(c);
+        cfg_seg_conn[seg][cfg_seg_count[seg]++] = c;
+    }
+    for (uint8_t c=1; c<=31; ++c) g_seg_conn_mask[g_con_seg[c]] |= CONN_BIT(c);
+}
+
 void handle_upload_map(const uint8_t *pay, uint8_t pal){
     if (pal < 1) return;
     const uint8_t N = pay[0];
@@ -81,6 +103,19 @@ void handle_upload_map(const uint8_t *pay, uint8_t pal){
         const uint8_t s = pay[1 + 2*i + 1];
         if (s == 0x01) cfg_conn[cfg_count++] = c;
     }
+    seg_lists_rebuild();   // segments come from SC_SEG_MAP, kept across uploads
     g_status_ext = 0x00;
 }
 
+void handle_seg_map(const uint8_t *pay, uint8_t pal){
+    if (pal < 1) return;
+    const uint8_t N = pay[0];
+    if (pal < (uint8_t)(1 + N)) return;
+    for (uint8_t c=0; c<32; ++c) g_con_seg[c] = 0;
+    for (uint8_t i=0; i<N; ++i){
+        const uint8_t c = pay[1 + i];
+        if (c >= 1 && c <= 31 && SLV_SEGS > 1) g_con_seg[c] = 1;
+    }
+    seg_lists_rebuild();
+}
+
@@ -1,6 +1,6 @@
 #include "board.h"
 
-/* UART0 on P0.2/P0.3, UART1 on P2.0/P2.1, relay GPIOs */
+/* UART0 on P0.2/P0.3, UART1 on P2.0/P2.1, UART3 on P0.0/P0.1, relay GPIOs */
 STATIC const PINMUX_GRP_T pinmuxing[] = {
     {0,  2, IOCON_MODE_INACT | IOCON_FUNC1}, /* TXD0 */
     {0,  3, IOCON_MODE_INACT | IOCON_FUNC1}, /* RXD0 */
@@ -9,6 +9,8 @@ STATIC const PINMUX_GRP_T pinmuxing[] = {
     {2,  1, IOCON_MODE_INACT | IOCON_FUNC2}, /* RXD1 */
 	{2,  8, IOCON_MODE_INACT | IOCON_FUNC2}, /* TXD2 on P2.8 */
 	{2,  9, IOCON_MODE_INACT | IOCON_FUNC2}, /* RXD2 on P2.9 */
+    {0,  0, IOCON_MODE_INACT | IOCON_FUNC2}, /* TXD3 (slave segment 1) */
+    {0,  1, IOCON_MODE_INACT | IOCON_FUNC2}, /* RXD3 */
 
     {4, 28, IOCON_MODE_INACT | IOCON_FUNC0}, /* Relay 1 */
     {0,  4, IOCON_MODE_INACT | IOCON_FUNC0}, /* Relay 2 */
@@ -37,6 +39,7 @@ void Board_SetupClocking(void) {
     Chip_Clock_SetPCLKDiv(SYSCTL_PCLK_UART0, SYSCTL_CLKDIV_1);
     Chip_Clock_SetPCLKDiv(SYSCTL_PCLK_UART1, SYSCTL_CLKDIV_1);
     Chip_Clock_SetPCLKDiv(SYSCTL_PCLK_UART2, SYSCTL_CLKDIV_1);
+    Chip_Clock_SetPCLKDiv(SYSCTL_PCLK_UART3, SYSCTL_CLKDIV_1);
 }
 
 void Board_SystemInit(void) {
@@ -41,7 +41,7 @@ void GPIO_IRQ_HANDLER(void){
     uint32_t stat_r = Chip_GPIOINT_GetStatusRising (LPC_GPIOINT, GPIOINT_PORT2);
     if (stat_r) Chip_GPIOINT_ClearIntStatus(LPC_GPIOINT, GPIOINT_PORT2, stat_r);
 
-    const uint16_t now = (uint16_t)g_tick;
+    const uint16_t now = (uint16_t)sched_now_tick();
 
     /* --- S1 (P2.4, BTN_P24_BIT) --- */
     if (stat_f & (1u << GPIO_BUTTON_S1_PIN)) {
@@ -9,73 +9,253 @@
 #include "queues.h"
 #include "u1_jobs.h"
 #include "u2_jobs.h"
+#include "job_mbox.h"
 #include "ws_led.h"
 #include "proto.h"
 #include "config.h"
 #include "chip.h"
+#include "isr_uart1.h"
+#include "app_status.h"
+#include "bitband.h"
+#include "xact.h"
+#include "tick_dom.h"
+#include "isr_rit.h"
+#include "swtimer.h"
 
 volatile uint32_t g_tick = 0;
 volatile uint16_t g_app_last_activity_tick = 0;
-volatile uint8_t  g_idle_ws_cleared = 0;
+volatile uint8_t  g_app_activity = 0;
+volatile uint8_t  g_app_idle = 0;
 
-volatile uint32_t g_alive_mask=0, g_triggered_mask=0;
-volatile uint32_t round_alive_mask=0, round_triggered_mask=0;
+// Bit-band SRAM: per-connector updates from the slave RX ISRs are single stores
+BITBAND_RAM volatile uint32_t g_alive_mask, g_triggered_mask;
+BITBAND_RAM volatile uint32_t round_alive_mask, round_triggered_mask;
 
 volatile uint8_t  g_off_broadcast_pending=0;
 volatile uint8_t  g_off_broadcast2_pending=0;
 
-static uint8_t poll_rr_idx=0;
-static bool led_active_prev=false;
+static uint8_t poll_rr_idx[SLV_SEGS];
 
-static inline void slave_enqueue_poll(uint8_t con){
+static inline void slave_enqueue_poll(uint8_t seg, uint8_t con){
     uint8_t f[9] = { SOF, GRP_RX_TO_SLV, 0x05, SC_SLAVE, con, 0x00, 0x00, 0x00, END_BYTE };
-    (void)u1q_push_isr(f, sizeof f);
+    (void)slvq_push_isr(seg, f, sizeof f);
+}
+static inline void slave_enqueue_poll_all(uint8_t seg, uint8_t max_addr){
+    uint8_t f[9] = { SOF, GRP_RX_TO_SLV, 0x05, SC_SLAVE, SLV_ADDR_BROADCAST, SLV_SUB_POLL_ALL,
+                     U1_TDMA_SLOT_MS, max_addr, END_BYTE };
+    (void)slvq_push_isr(seg, f, sizeof f);
 }
 static inline void slave_enqueue_led_off_broadcast(void){
     uint8_t f[8] = { SOF, GRP_RX_TO_SLV, 0x04, SC_SLAVE, 0xFF, 0x03, 0x00, END_BYTE };
-    (void)u1q_push_isr(f, sizeof f);
+    for (uint8_t g = 0; g < SLV_SEGS; ++g){
+        xact_cancel_seg(g);   // no stale LED-ON retry after the OFF
+        (void)slvq_push_isr(g, f, sizeof f);
+    }
+    u1_shadow_invalidate_all();
+}
+
+// Idle watchdog: ACTIVE -> OFF_BURST (IDLE_OFF_REPEATS OFFs, spaced) -> QUIET (slow reassert).
+// Leaves idle on the first App byte (g_app_activity, cleared on entry), however long idle lasted.
+// One software timer drives it: the idle-entry check while ACTIVE, the next OFF afterwards.
+typedef enum { IDLE_ACTIVE = 0, IDLE_OFF_BURST, IDLE_QUIET } idle_state_t;
+static idle_state_t s_idle = IDLE_ACTIVE;
+static uint8_t      s_idle_offs;     // OFFs sent in the current burst
+static void idle_tmr_fn(SwTimer *t);
+static SwTimer      s_idle_tmr = SWTIMER_INIT(idle_tmr_fn);
+
+static inline void idle_send_off(void){
+    slave_enqueue_led_off_broadcast();
+    bin_enqueue_led_off_broadcast_uart2();
+}
+
+static void idle_tmr_fn(SwTimer *t){
+    if (s_idle == IDLE_ACTIVE){
+        // App bytes only stamp g_app_last_activity_tick; the deadline moves out here, once
+        const uint16_t act = g_app_last_activity_tick;
+        const int16_t quiet = (int16_t)((uint16_t)g_tick - act);
+        if (quiet < (int16_t)APP_IDLE_TICKS){ swtimer_start(t, (uint32_t)(APP_IDLE_TICKS - quiet)); return; }
+        s_idle = IDLE_OFF_BURST; s_idle_offs = 0;
+        g_app_activity = 0;   // UART0 is lower priority: no byte slips in between
+        g_app_idle = 1;   // the domains skip polling and LED jobs meanwhile
+        ws_clear_all();
+        ws_request_flush();
+    }
+    idle_send_off();
+    if (s_idle == IDLE_OFF_BURST && ++s_idle_offs < IDLE_OFF_REPEATS){
+        swtimer_start(t, IDLE_OFF_SPACING_TICKS);
+        return;
+    }
+    s_idle = IDLE_QUIET;
+#if IDLE_REASSERT_TICKS
+    swtimer_start(t, IDLE_REASSERT_TICKS);
+#endif
+}
+
+// Per RIT tick: leave idle on the first App byte (resume this very tick)
+static void idle_check(void){
+    if (s_idle == IDLE_ACTIVE){
+        if (!swtimer_pending(&s_idle_tmr)) swtimer_start(&s_idle_tmr, APP_IDLE_TICKS);   // first tick
+        return;
+    }
+    if (!g_app_activity) return;
+    s_idle = IDLE_ACTIVE; g_app_idle = 0;
+    swtimer_start(&s_idle_tmr, APP_IDLE_TICKS);
+}
+
+#if TICKLESS
+// RIT compare = s_rit_span ticks; the counter clears on match, so g_tick + counter/s_rit_cyc is "now"
+static uint32_t          s_rit_cyc = 1;
+static volatile uint32_t s_rit_span = 1;
+
+void sched_tickless_init(void){
+    s_rit_cyc = (Chip_Clock_GetPeripheralClockRate(SYSCTL_PCLK_RIT) / 1000u) * RIT_TICK_MS;
 }
 
-void sched_commit_and_clear_poll_round(void){
-    g_alive_mask     = round_alive_mask;
-    g_triggered_mask = round_triggered_mask & g_alive_mask;
-    round_alive_mask=0; round_triggered_mask=0;
+uint32_t sched_now_tick(void){
+    uint32_t t, c;
+    do { t = g_tick; c = Chip_RIT_GetCounter(LPC_RITIMER); } while (t != g_tick);   // RIT fired in between
+    return t + c / s_rit_cyc;
 }
 
-extern uint8_t cfg_conn[MAX_CFG];
-extern uint8_t cfg_count;
+void sched_wake(void){
+    if (s_rit_span <= 1) return;
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();                      // RIT must not re-program the compare under us
+    const uint32_t span = s_rit_span;
+    for (uint32_t next = Chip_RIT_GetCounter(LPC_RITIMER) / s_rit_cyc + 1u; next < span; ++next){
+        Chip_RIT_SetCOMPVAL(LPC_RITIMER, next * s_rit_cyc);
+        // Counter already past the new compare (it kept running since the read)? That
+        // would only match after the 32-bit wrap: re-check and take the tick after it.
+        if (Chip_RIT_GetCounter(LPC_RITIMER) < next * s_rit_cyc){ s_rit_span = next; break; }
+        if (next + 1u == span) Chip_RIT_SetCOMPVAL(LPC_RITIMER, span * s_rit_cyc);   // keep the span end
+    }
+    __set_PRIMASK(primask);
+}
+
+// Ticks until something needs RIT or a domain: 1 = keep ticking
+static uint32_t tickless_span(void){
+    if (xact_busy() || g_off_broadcast_pending || g_off_broadcast2_pending || ws_fx_active()) return 1;
+    if (!g_app_idle){
+        if (u1_jobs_due_any() || g_u1_multi.mask || u2_jobs_due_any()) return 1;   // frames to send
+        for (uint8_t g = 0; g < SLV_SEGS; ++g) if (cfg_seg_count[g]) return 1;      // poll rounds
+    }
+    // Idle OFFs, idle entry, job refreshes / ack retries: all on the timer wheel
+    return swtimer_ticks_to_next(TICKLESS_MAX_TICKS);
+}
+
+static void tickless_program_next(void){
+    const uint32_t span = tickless_span();
+    if (span > 1) tick_dom_suspend(); else tick_dom_resume();
+    s_rit_span = span;
+    Chip_RIT_SetCOMPVAL(LPC_RITIMER, span * s_rit_cyc);   // counter just cleared on the match
+}
+#endif
+
+void sched_commit_and_clear_poll_round(uint32_t seg_mask){
+    const uint32_t alive = mask_take(&round_alive_mask, seg_mask);
+    const uint32_t trig  = mask_take(&round_triggered_mask, seg_mask);
+    mask_assign(&g_alive_mask, seg_mask, alive);
+    mask_assign(&g_triggered_mask, seg_mask, trig & alive);
+}
+
+#if U1_POLL_TDMA
+static uint8_t tdma_ticks_left[SLV_SEGS];   // >0 while a broadcast-poll window is open
+
+static uint8_t seg_max_addr(uint8_t seg){
+    uint8_t m = 0;
+    for (uint8_t i = 0; i < cfg_seg_count[seg]; ++i){
+        const uint8_t c = cfg_seg_conn[seg][i];
+        if (c <= 31 && c > m) m = c;
+    }
+    return m;
+}
+// Broadcast on the wire + max_addr reply slots, rounded up to whole ticks
+// (slave-domain ticks)
+static inline uint8_t tdma_round_ticks(uint8_t max_addr){
+    const uint32_t ms = (9u * U1_BYTE_US + 999u) / 1000u + (uint32_t)max_addr * U1_TDMA_SLOT_MS;
+    const uint8_t per = tick_dom_period_ms(DOM_SLV);
+    return (uint8_t)((ms + per - 1) / per + 1);
+}
+#endif
+
+// One slave-bus segment per call: stream one due LED frame, else poll.
+// Change-only LED jobs leave most ticks free: polling interleaves with them,
+// and the poll round simply continues where it left off.
+static void slave_seg_tick(uint8_t seg){
+#if U1_POLL_TDMA
+    // An open TDMA window owns the bus: LED frames would collide with slot replies
+    if (tdma_ticks_left[seg]){
+        if (--tdma_ticks_left[seg]) return;
+        u1_tdma_window_close(seg);
+    }
+#endif
+    if (slvq_pending(seg)) return;   // previous frame not on the wire yet: keep the spacing
+    if (xact_run(seg)) return;   // a transaction owns the segment until it finishes
+    if (u1_scheduler_emit_one(seg)) return;
+
+    const uint8_t n = cfg_seg_count[seg];
+    if (!n) return;
+#if U1_POLL_TDMA
+    // One broadcast per round; silent slaves simply miss their slot
+    sched_commit_and_clear_poll_round(g_seg_conn_mask[seg]);
+    const uint8_t max_addr = seg_max_addr(seg);
+    if (max_addr){
+        u1_tdma_round_arm(seg);
+        slave_enqueue_poll_all(seg, max_addr);
+        tdma_ticks_left[seg] = tdma_round_ticks(max_addr);
+    }
+#else
+    if (poll_rr_idx[seg] >= n) poll_rr_idx[seg] = 0;   // map shrank
+    if (poll_rr_idx[seg] == 0) sched_commit_and_clear_poll_round(g_seg_conn_mask[seg]);
+    slave_enqueue_poll(seg, cfg_seg_conn[seg][poll_rr_idx[seg]]);
+    if (++poll_rr_idx[seg] >= n) poll_rr_idx[seg] = 0;
+#endif
+}
 
 void RIT_IRQHandler(void){
     Chip_RIT_ClearInt(LPC_RITIMER);
+#if TICKLESS
+    g_tick += s_rit_span;
+#else
     g_tick++;
+#endif
+
+    idle_check();
+    swtimer_run(g_tick);
+
+    // App job operations next: the job tables are only ever written at this priority
+    job_mbox_apply_all();
 
     if (g_off_broadcast_pending){  slave_enqueue_led_off_broadcast();      g_off_broadcast_pending=0; }
     if (g_off_broadcast2_pending){ bin_enqueue_led_off_broadcast_uart2();  g_off_broadcast2_pending=0; }
 
-    const bool app_idle = ((int16_t)((uint16_t)g_tick - g_app_last_activity_tick) >= (int16_t)APP_IDLE_TICKS);
-    if (app_idle){
-        slave_enqueue_led_off_broadcast();
-        bin_enqueue_led_off_broadcast_uart2();
-        if (!g_idle_ws_cleared){ ws_clear_all(); g_idle_ws_cleared = 1; }
-        ws_request_flush();
+#if !TICK_DOMAINS
+    dom_slv_tick();
+    dom_ws_tick();
+    dom_bin_tick();
+#endif
+#if TICKLESS
+    tickless_program_next();
+#endif
+}
+
+// ---- Tick domains (TIMER0 match channels, see tick_dom.h; or every RIT tick) ----
+void dom_slv_tick(void){
+    if (g_app_idle){
+        for (uint8_t g = 0; g < SLV_SEGS; ++g) (void)xact_run(g);   // keep timeouts honest
         return;
     }
-    g_idle_ws_cleared = 0;
-
-    if (u1_scheduler_emit_one()){
-        led_active_prev = true;
-        ws_request_flush();  // WS may have changed in LED CTRL
-    } else {
-        if (led_active_prev){ led_active_prev=false; poll_rr_idx=0; }
-        if (cfg_count){
-            if (poll_rr_idx == 0) sched_commit_and_clear_poll_round();
-            const uint8_t con = cfg_conn[poll_rr_idx];
-            slave_enqueue_poll(con);
-            if (++poll_rr_idx >= cfg_count) poll_rr_idx=0;
-        }
-        ws_request_flush();
-    }
+    for (uint8_t g = 0; g < SLV_SEGS; ++g) slave_seg_tick(g);
+}
 
+void dom_bin_tick(void){
+    if (g_app_idle || u2q_pending()) return;
+    if (xact_run(XACT_BUS_BIN)) return;   // LED-ON read-back in progress
     (void)u2_scheduler_emit_one(); // one BIN job per tick
 }
 
+void dom_ws_tick(void){
+    ws_fx_tick(tick_dom_period_ms(DOM_WS));
+    ws_request_flush();  // WS may have changed in LED CTRL or an effect step
+}
+
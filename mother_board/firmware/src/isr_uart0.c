@@ -10,18 +10,20 @@
 #include "queues.h"
 #include "u1_jobs.h"
 #include "u2_jobs.h"
+#include "job_mbox.h"
 #include "ws_led.h"
 #include "app_status.h"
 #include "sched.h"
 #include "buttons.h"
+#include "bitband.h"
+#include "tick_dom.h"
 
 #include "chip.h"
 
 // ---- App handlers ----
 static void handle_led_reset(const uint8_t *pay, uint8_t pal){
     (void)pay; (void)pal;
-    u1_jobs_clear_all();
-    u2_jobs_stop_all();
+    (void)job_mbox_stop_all(JOB_BUS_U1 | JOB_BUS_U2);
     ws_clear_all();
     extern volatile uint8_t g_off_broadcast_pending, g_off_broadcast2_pending;
     g_off_broadcast_pending  = 1;
@@ -52,10 +54,11 @@ static void handle_btnflag_reset(const uint8_t *pay, uint8_t pal){
     (void)pay; (void)pal;
     g_status_ext = 0x00;
 
-    const uint32_t view_alive = (g_alive_mask | round_alive_mask);
-    const uint32_t view_trig  = ((g_triggered_mask | round_triggered_mask) & view_alive);
+    const uint32_t round_alive = round_alive_mask, round_trig = round_triggered_mask;
+    const uint32_t view_alive = (g_alive_mask | round_alive);
+    const uint32_t view_trig  = ((g_triggered_mask | round_trig) & view_alive);
 
-    g_force01_while_triggered_mask |= view_trig;
+    mask_or(&g_force01_while_triggered_mask, view_trig);
 
     // OFF immediately on both buses + WS clear
     extern volatile uint8_t g_off_broadcast_pending, g_off_broadcast2_pending;
@@ -64,8 +67,7 @@ static void handle_btnflag_reset(const uint8_t *pay, uint8_t pal){
     ws_clear_all();
 
     // Stop active jobs so OFF persists
-    u1_jobs_clear_all();
-    u2_jobs_stop_all();
+    (void)job_mbox_stop_all(JOB_BUS_U1 | JOB_BUS_U2);
 }
 
 static inline bool is_conn_configured(uint8_t con){
@@ -79,21 +81,27 @@ static void handle_led1_multi_con(const uint8_t *pay, uint8_t pal){
     uint8_t n = pay[0];
     if (!n || pal < (uint8_t)(1 + n)) return;
 
-    NVIC_DisableIRQ(RITIMER_IRQn);
+#if U1_LED_MULTICAST
+    // One multicast frame lights (and refreshes) every listed connector at once
+    uint32_t mask = 0;
     for (uint8_t i=0;i<n;++i){
         const uint8_t con = pay[1+i];
         if (con < 1 || con > 31) continue;
         if (!is_conn_configured(con)) continue;
-
-        u1_jobs_remove_by_con_except(con, 1);
-        uint8_t idx = u1_job_find(con, 1);
-        if (idx == 0xFF) idx = u1_job_alloc(con, 1);
-        if (idx != 0xFF){
-            g_u1_jobs[idx].next_allowed_tick = (uint16_t)g_tick;
-            u1_jobs_rr = idx;
-        }
+        mask |= CONN_BIT(con);
+    }
+    if (mask){
+        const JobOp op = { JOB_OP_U1_MULTI, JOB_BUS_U1, 0, 1, 0, mask };
+        (void)job_mbox_post(&op);
     }
-    NVIC_EnableIRQ(RITIMER_IRQn);
+#else
+    for (uint8_t i=0;i<n;++i){
+        const uint8_t con = pay[1+i];
+        if (con < 1 || con > 31) continue;
+        if (!is_conn_configured(con)) continue;
+        (void)job_mbox_replace(JOB_BUS_U1, con, 1, 0);
+    }
+#endif
 }
 
 // SC=0x0B: BIN multi-mask, and mirror WS to exact mask
@@ -103,14 +111,41 @@ static void handle_bin_led_mask(const uint8_t *pay, uint8_t pal){
     if (!max_led || pal < (uint8_t)(1 + max_led)) return;
 
     ws_set_mask_bin1_and_clear_others(max_led, &pay[1]);
-    u2_jobs_stop_all(); // avoid per-LED interference
-    bin_enqueue_multi_mask_uart2(max_led, &pay[1]);
+    (void)job_mbox_stop_all(JOB_BUS_U2); // avoid per-LED interference; BIN LEDs now follow the mask
+    (void)job_mbox_u2_mask(max_led, &pay[1]);   // frames built and queued by RIT: one UART2 ring producer
+}
+
+// SC=0x0C: tick-domain periods [slv_ms, bin_ms, ws_ms]; 0 or absent = keep
+static void handle_tick_periods(const uint8_t *pay, uint8_t pal){
+    for (uint8_t d = 0; d < DOM_COUNT && d < pal; ++d) (void)tick_dom_set_period(d, pay[d]);
+}
+
+// SC=0x0D: WS effect [slot, kind, bin, led, count, colour, period (10 ms), arg];
+// long segments: [slot, kind, bin, led_hi, led_lo, cnt_hi, cnt_lo, colour, period, arg]
+// [slot, 00] stops the slot, [FF, 00] stops every slot
+static void handle_ws_effect(const uint8_t *pay, uint8_t pal){
+    if (pal < 2) return;
+    const uint8_t slot = pay[0], kind = pay[1];
+    if (kind == WS_FX_NONE){
+        if (slot == 0xFF) ws_fx_stop_all();
+        else (void)ws_fx_set(slot, WS_FX_NONE, 0, 0, 0, 0, 0, 0);
+        return;
+    }
+    if (pal >= 10){
+        (void)ws_fx_set(slot, kind, pay[2], (uint16_t)((pay[3] << 8) | pay[4]), (uint16_t)((pay[5] << 8) | pay[6]),
+                        pay[7], (uint16_t)(pay[8] * 10u), pay[9]);
+        return;
+    }
+    if (pal < 8) return;
+    (void)ws_fx_set(slot, kind, pay[2], pay[3], pay[4], pay[5], (uint16_t)(pay[6] * 10u), pay[7]);
 }
 
 // ===== SC=0x02 LED CTRL with mode byte after SC =====
-// mode=0x00: [00, 00, 00, 02, bin, led]  // legacy-as-current → BIN + WS(mirror if bin==1)
-// mode=0x01: [01, con, led]              // UART1
-// mode=0x02: [02, bin, bin_led, flags, con, con_led] // BIN + UART1 in one command
+// mode=0x00: [00, 00, 00, 02, bin, led, (flags)]  // legacy-as-current → BIN + WS (strips mirroring bin)
+// mode=0x01: [01, con, led, (flags)]              // UART1
+// mode=0x02: [02, bin, bin_led, xx, con, con_led, (flags)] // BIN + UART1 in one command
+// flags: LEDF_* (proto.h) — one-shot / slow refresh / urgent; absent = 0.
+// Mode 2's 4th byte has always been ignored and still is: Apps send 0 or junk there.
 static void handle_led_ctrl(const uint8_t *pay, uint8_t pal){
     if (pal < 3) return;
     const uint8_t mode = pay[0];
@@ -119,34 +154,20 @@ static void handle_led_ctrl(const uint8_t *pay, uint8_t pal){
         if (pal < 6) return;
         if (pay[1]!=0x00 || pay[2]!=0x00 || pay[3]!=0x02) return;
         const uint8_t bin = pay[4], led = pay[5];
+        const uint8_t flags = (pal >= 7) ? pay[6] : 0;
 
-        NVIC_DisableIRQ(RITIMER_IRQn);
-        u2_jobs_remove_by_bin_except(bin, led);
-        u2_job_start(bin, led);
-        uint8_t idx = u2_job_find(bin, led);
-        if (idx != 0xFF){
-            g_u2_jobs[idx].next_allowed_tick = (uint16_t)g_tick;
-            u2_jobs_rr = idx;
-        }
-        NVIC_EnableIRQ(RITIMER_IRQn);
+        (void)job_mbox_replace(JOB_BUS_U2, bin, led, flags);
 
-        if (bin == 1) ws_set_only_bin1(led);
+        ws_set_only_bin(bin, led);
         return;
     }
 
     if (mode == 0x01){
         if (pal < 3) return;
         const uint8_t con = pay[1], led = pay[2];
+        const uint8_t flags = (pal >= 4) ? pay[3] : 0;
 
-        NVIC_DisableIRQ(RITIMER_IRQn);
-        u1_jobs_remove_by_con_except(con, led);
-        uint8_t idx = u1_job_find(con, led);
-        if (idx == 0xFF) idx = u1_job_alloc(con, led);
-        if (idx != 0xFF){
-            g_u1_jobs[idx].next_allowed_tick = (uint16_t)g_tick;
-            u1_jobs_rr = idx;
-        }
-        NVIC_EnableIRQ(RITIMER_IRQn);
+        (void)job_mbox_replace(JOB_BUS_U1, con, led, flags);
         return;
     }
 
@@ -154,32 +175,14 @@ static void handle_led_ctrl(const uint8_t *pay, uint8_t pal){
         if (pal < 6) return;
         const uint8_t bin     = pay[1];
         const uint8_t bin_led = pay[2];
-        // const uint8_t flags = pay[3];
         const uint8_t con     = pay[4];
         const uint8_t con_led = pay[5];
+        const uint8_t flags   = (pal >= 7) ? pay[6] : 0;
 
-        // BIN side
-        NVIC_DisableIRQ(RITIMER_IRQn);
-        u2_jobs_remove_by_bin_except(bin, bin_led);
-        u2_job_start(bin, bin_led);
-        uint8_t bidx = u2_job_find(bin, bin_led);
-        if (bidx != 0xFF){
-            g_u2_jobs[bidx].next_allowed_tick = (uint16_t)g_tick;
-            u2_jobs_rr = bidx;
-        }
-        NVIC_EnableIRQ(RITIMER_IRQn);
-        if (bin == 1) ws_set_only_bin1(bin_led);
-
-        // UART1 side
-        NVIC_DisableIRQ(RITIMER_IRQn);
-        u1_jobs_remove_by_con_except(con, con_led);
-        uint8_t cidx = u1_job_find(con, con_led);
-        if (cidx == 0xFF) cidx = u1_job_alloc(con, con_led);
-        if (cidx != 0xFF){
-            g_u1_jobs[cidx].next_allowed_tick = (uint16_t)g_tick;
-            u1_jobs_rr = cidx;
-        }
-        NVIC_EnableIRQ(RITIMER_IRQn);
+        // BIN side, then UART1 side: both applied in the same RIT tick
+        (void)job_mbox_replace(JOB_BUS_U2, bin, bin_led, flags);
+        ws_set_only_bin(bin, bin_led);
+        (void)job_mbox_replace(JOB_BUS_U1, con, con_led, flags);
         return;
     }
     // unknown mode → ignore
@@ -209,6 +212,9 @@ static void dispatch_app_frame(const uint8_t *p, uint8_t len){
         case SC_BTNFLAG_RESET: handle_btnflag_reset(pay, pal);      break; //rest the s1 s2 sw to 00
         case SC_STATUS:        handle_led1_multi_con(pay, pal);     break; //turn ON led 1 on alive cons
         case SC_BIN_MASK:      handle_bin_led_mask(pay, pal);       break; //turn ON leds numbers on addressable led and BIN
+        case SC_TICK_PERIODS:  handle_tick_periods(pay, pal);       break; //per-bus tick periods (ms)
+        case SC_WS_EFFECT:     handle_ws_effect(pay, pal);          break; //blink / pulse / chase on WS LEDs
+        case SC_SEG_MAP:       handle_seg_map(pay, pal);            break; //connectors served by UART3
         default: break;
     }
     request_status_reply();
@@ -217,7 +223,8 @@ static void dispatch_app_frame(const uint8_t *p, uint8_t len){
 void UART0_IRQHandler(void){
     while (Chip_UART_ReadLineStatus(LPC_UART0) & UART_LSR_RDR){
         const uint8_t b = Chip_UART_ReadByte(LPC_UART0);
-        g_app_last_activity_tick = (uint16_t)g_tick;
+        sched_app_activity();
+        sched_wake();   // TICKLESS: end a long RIT span at the next tick (leave idle, apply job ops)
         switch (rx_state){
         case RXF_WAIT_SOF:      if (b == SOF) rx_state = RXF_WAIT_LEN; break;
         case RXF_WAIT_LEN:
@@ -9,53 +9,80 @@
 #include "sched.h"
 #include "config.h"
 #include "chip.h"
+#include "isr_uart1.h"
+#include "bitband.h"
+#include "u1_jobs.h"
+#include "app_status.h"
+#include "xact.h"
+#include "slv_frame.h"
 
-typedef enum { U1_WAIT_SOF=0, U1_GOT_SOF, U1_WAIT_LEN, U1_COLLECT, U1_WAIT_END } u1_fsm_t;
-static volatile u1_fsm_t u1_state = U1_WAIT_SOF;
-static volatile uint8_t  u1_len   = 0, u1_idx = 0;
-static uint8_t           u1_pay[8];
+static SlvFrameRx u1_rx;
+
+#if U1_POLL_TDMA
+// Round stamp: odd while RIT has a round running, even once it closed it.
+// The window is open only while the stamp it was opened with is still current.
+static volatile uint32_t s_tdma_round[SLV_SEGS];
+static volatile uint32_t s_tdma_open[SLV_SEGS];
+static volatile uint32_t s_tdma_t0[SLV_SEGS];   // DWT stamp: start of slot 1
+static uint32_t          s_tdma_slot_cyc = 1;
+
+void     u1_tdma_round_arm(uint8_t seg){ s_tdma_round[seg] |= 1u; }
+uint32_t u1_tdma_round(uint8_t seg){ return s_tdma_round[seg]; }
+
+void u1_tdma_window_open(uint8_t seg, uint32_t round){
+    if (!(round & 1u)) return;                    // sent outside a round
+    s_tdma_slot_cyc  = (SystemCoreClock / 1000u) * U1_TDMA_SLOT_MS;
+    s_tdma_t0[seg]   = DWT->CYCCNT;
+    s_tdma_open[seg] = round;                     // stale if RIT closed it meanwhile
+}
+void u1_tdma_window_close(uint8_t seg){
+    if (s_tdma_round[seg] & 1u) s_tdma_round[seg]++;
+}
+
+/* Slave `addr` starts its reply (addr-1) slots after the broadcast. Its END
+   is seen in that slot, or one later when the RX FIFO timeout delays the IRQ. */
+static inline bool tdma_slot_ok(uint8_t seg, uint8_t addr){
+    const uint32_t round = s_tdma_round[seg];
+    if (!(round & 1u) || s_tdma_open[seg] != round) return true;
+    const uint32_t slot = (DWT->CYCCNT - s_tdma_t0[seg]) / s_tdma_slot_cyc;
+    return (slot + 1u == addr) || (slot == addr);
+}
+#endif
+
+// [SC_STATUS, addr, st] or, with LED ack, [SC_STATUS, addr, st, led]
+static void slave_apply_status(uint8_t seg, const uint8_t *pay, uint8_t len){
+    if ((len != 3 && len != 4) || pay[0] != SC_STATUS) return;
+    const uint8_t addr = pay[1], st = pay[2];
+    if (addr < 1 || addr > 31 || !st) return;
+    if (con_seg(addr) != seg) return;              // not wired to this segment
+#if U1_POLL_TDMA
+    if (!tdma_slot_ok(seg, addr)) return;
+#endif
+    // Bit-band stores: RIT (higher priority) may commit the masks at any point
+    const uint8_t bit = (uint8_t)(addr - 1);
+    bb_set(&round_alive_mask, bit);
+#if LED_ACK_MODE
+    if (len == 4) g_u1_ack_led[addr] = pay[3];
+#endif
+    bb_write(&round_triggered_mask, bit, st == 0x03);
+    // Streaming snapshot (optional)
+    if (g_led_streaming_active){
+        bb_set(&g_alive_mask, bit);
+        bb_write(&g_triggered_mask, bit, st == 0x03);
+    }
+}
+
+// Status replies update the masks / LED ack first, then a pending transaction
+// on the segment may take the reply (its done callback then sees the ack).
+void slave_rx_status(uint8_t seg, const uint8_t *pay, uint8_t len){
+    if (seg >= SLV_SEGS) return;
+    slave_apply_status(seg, pay, len);
+    (void)xact_rx(seg, pay, len);
+}
 
 void UART1_IRQHandler(void){
     while (Chip_UART_ReadLineStatus(LPC_UART1) & UART_LSR_RDR){
-        const uint8_t b = Chip_UART_ReadByte(LPC_UART1);
-        switch (u1_state){
-        case U1_WAIT_SOF: if (b == SOF) u1_state = U1_GOT_SOF; break;
-        case U1_GOT_SOF:
-            if (b == SOF) { u1_state = U1_WAIT_LEN; }
-            else {
-                u1_len = b; u1_idx = 0;
-                if (!u1_len || u1_len > sizeof(u1_pay)) { u1_state = U1_WAIT_SOF; break; }
-                u1_state = U1_COLLECT;
-            }
-            break;
-        case U1_WAIT_LEN:
-            u1_len = b; u1_idx = 0;
-            if (!u1_len || u1_len > sizeof(u1_pay)) { u1_state = U1_WAIT_SOF; break; }
-            u1_state = U1_COLLECT; break;
-        case U1_COLLECT:
-            u1_pay[u1_idx++] = b;
-            if (u1_idx == u1_len) u1_state = U1_WAIT_END;
-            break;
-        case U1_WAIT_END:
-            if (b == END_BYTE && u1_len == 3 && u1_pay[0] == SC_STATUS){
-                const uint8_t addr = u1_pay[1], st = u1_pay[2];
-                if (addr >= 1 && addr <= 31 && st){
-                    const uint32_t bit = CONN_BIT(addr);
-                    round_alive_mask |= bit;
-                    if (st == 0x03) round_triggered_mask |= bit;
-                    else            round_triggered_mask &= ~bit;
-                    // Streaming snapshot (optional)
-                    extern volatile bool g_led_streaming_active;
-                    if (g_led_streaming_active){
-                        g_alive_mask |= bit;
-                        if (st == 0x03) g_triggered_mask |= bit;
-                        else            g_triggered_mask &= ~bit;
-                    }
-                }
-            }
-            u1_state = U1_WAIT_SOF; break;
-        default: u1_state = U1_WAIT_SOF; break;
-        }
+        const uint8_t n = slv_frame_rx(&u1_rx, Chip_UART_ReadByte(LPC_UART1));
+        if (n) slave_rx_status(0, u1_rx.pay, n);
     }
 }
-
@@ -0,0 +1,31 @@
+/*
+ * isr_uart2.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "proto.h"
+#include "config.h"
+#include "u2_jobs.h"
+#include "chip.h"
+#include "isr_uart2.h"
+#include "slv_frame.h"
+#include "xact.h"
+
+#if LED_ACK_MODE
+
+static SlvFrameRx u2_rx;
+
+void UART2_IRQHandler(void){
+    while (Chip_UART_ReadLineStatus(LPC_UART2) & UART_LSR_RDR){
+        const uint8_t n = slv_frame_rx(&u2_rx, Chip_UART_ReadByte(LPC_UART2));
+        if (n == 4 && u2_rx.pay[0] == SC_STATUS){
+            const uint8_t bin = u2_rx.pay[1];
+            if (bin >= 1 && bin <= MAX_BIN) g_u2_ack_led[bin] = u2_rx.pay[3];
+        }
+        if (n) (void)xact_rx(XACT_BUS_BIN, u2_rx.pay, n);   // after the ack store: done sees it
+    }
+}
+
+#endif /* LED_ACK_MODE */
@@ -0,0 +1,22 @@
+/*
+ * isr_uart3.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "proto.h"
+#include "config.h"
+#include "chip.h"
+#include "isr_uart1.h"
+#include "isr_uart3.h"
+#include "slv_frame.h"
+
+static SlvFrameRx u3_rx;
+
+void UART3_IRQHandler(void){
+    while (Chip_UART_ReadLineStatus(LPC_UART3) & UART_LSR_RDR){
+        const uint8_t n = slv_frame_rx(&u3_rx, Chip_UART_ReadByte(LPC_UART3));
+        if (n) slave_rx_status(1, u3_rx.pay, n);
+    }
+}
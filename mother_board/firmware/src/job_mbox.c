@@ -0,0 +1,70 @@
+/*
+ * job_mbox.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "job_mbox.h"
+#include "u1_jobs.h"
+#include "u2_jobs.h"
+#include "bitmap.h"
+#include <string.h>
+
+static volatile uint8_t mb_head=0, mb_tail=0;
+static JobOp mb_q[JOB_MBOX_CAP];
+volatile uint32_t job_mbox_drops=0;
+
+// Staged SC_BIN_MASK list. The writer clears s_mask_ok first: an op that RIT
+// applies mid-copy is skipped, and the op being posted sends the new list.
+static volatile uint8_t s_mask_ok;
+static uint8_t s_mask_len, s_mask[RX_LEN_MAX];
+
+bool job_mbox_post(const JobOp *op){
+    const uint8_t next = (uint8_t)((mb_head + 1) % JOB_MBOX_CAP);
+    if (next == mb_tail) { job_mbox_drops++; return false; }
+    mb_q[mb_head] = *op; mb_head = next; return true;
+}
+
+bool job_mbox_u2_mask(uint8_t max_led, const uint8_t *list){
+    if (max_led > sizeof s_mask) max_led = sizeof s_mask;
+    s_mask_ok = 0;
+    __DMB();
+    memcpy(s_mask, list, max_led); s_mask_len = max_led;
+    __DMB();
+    s_mask_ok = 1;
+    const JobOp op = { JOB_OP_U2_MASK, JOB_BUS_U2, 0, 0, 0, 0 };
+    return job_mbox_post(&op);
+}
+
+static void job_mbox_apply(const JobOp *op){
+    switch (op->op){
+    case JOB_OP_REPLACE:
+        if (op->bus & JOB_BUS_U1) u1_jobs_remove_by_con_except(op->id, op->led);
+        if (op->bus & JOB_BUS_U2) u2_jobs_remove_by_bin_except(op->id, op->led);
+        /* fall through */
+    case JOB_OP_START:
+        if (op->bus & JOB_BUS_U1) (void)u1_job_start(op->id, op->led, op->flags);
+        if (op->bus & JOB_BUS_U2) (void)u2_job_start(op->id, op->led, op->flags);
+        break;
+    case JOB_OP_STOP_ALL:
+        if (op->bus & JOB_BUS_U1){ u1_jobs_clear_all();  u1_shadow_invalidate_all(); }
+        if (op->bus & JOB_BUS_U2){ u2_jobs_stop_all();   u2_shadow_invalidate_all(); }
+        break;
+    case JOB_OP_U1_MULTI:
+        for (uint32_t m=op->mask; m; m &= m - 1) u1_jobs_remove_by_con_except((uint8_t)(bitmap_first(m) + 1), 0);
+        if (op->mask) u1_multi_add(op->mask, op->led);
+        break;
+    case JOB_OP_U2_MASK:
+        if (s_mask_ok) bin_enqueue_multi_mask_uart2(s_mask_len, s_mask);
+        break;
+    default: break;
+    }
+}
+
+void job_mbox_apply_all(void){
+    while (mb_tail != mb_head){
+        job_mbox_apply(&mb_q[mb_tail]);
+        mb_tail = (uint8_t)((mb_tail + 1) % JOB_MBOX_CAP);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * main_rtos.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "config.h"
+
+#if APP_USE_FREERTOS   // superloop build: see main.c
+
+#include "chip.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "ws_led.h"
+#include "app_io.h"
+#include "app_wake.h"
+
+// Task priorities: the fast App link first, slow 9600-baud buses below it, WS last
+#define TASK_PRIO_APP   (tskIDLE_PRIORITY + 3)
+#define TASK_PRIO_BUS   (tskIDLE_PRIORITY + 2)
+#define TASK_PRIO_WS    (tskIDLE_PRIORITY + 1)
+#define TASK_STACK      (configMINIMAL_STACK_SIZE + 64)
+
+static TaskHandle_t s_wake_task[WAKE_COUNT];
+
+void app_wake_from_isr(uint8_t src){
+    if (src >= WAKE_COUNT || !s_wake_task[src]) return;   // scheduler not started yet
+    BaseType_t hpw = pdFALSE;
+    vTaskNotifyGiveFromISR(s_wake_task[src], &hpw);
+    portYIELD_FROM_ISR(hpw);
+}
+
+// ---- Run-time stats: DWT cycles accumulated into 64 bits. CYCCNT wraps every
+// ~44.7 s at 96 MHz; the 1 ms tick hook folds it in, so no wrap is missed even
+// when no task runs for minutes (App idle). The result is the low 32 bits of
+// the 1024-cycle count: it wraps cleanly (~12.7 h), as FreeRTOS expects.
+static uint32_t s_rt_last;
+static uint64_t s_rt_cyc;
+void rtos_runtime_init(void){ s_rt_last = DWT->CYCCNT; s_rt_cyc = 0; }
+unsigned long rtos_runtime_counter(void){
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();                      // tick hook vs. a task-level stats read
+    const uint32_t now = DWT->CYCCNT;
+    s_rt_cyc += (uint32_t)(now - s_rt_last);
+    s_rt_last = now;
+    const uint32_t v = (uint32_t)(s_rt_cyc >> 10);
+    __set_PRIMASK(primask);
+    return (unsigned long)v;
+}
+
+void vApplicationTickHook(void){ (void)rtos_runtime_counter(); }
+
+// ---- Tasks: block on their notification, then drain their source
+static void app_tx_task(void *arg){
+    (void)arg;
+    for (;;){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (app_io_service_app_tx()) {}
+    }
+}
+
+static void slave_tx_task(void *arg){
+    const uint8_t seg = (uint8_t)(uintptr_t)arg;
+    for (;;){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (app_io_service_slave_tx(seg)) {}
+    }
+}
+
+static void bin_tx_task(void *arg){
+    (void)arg;
+    for (;;){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (app_io_service_bin_tx()) {}
+    }
+}
+
+static void ws_task(void *arg){
+    (void)arg;
+    for (;;){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Bit-banged timing: keep other tasks off the CPU (ISRs still run, as in the superloop)
+        vTaskSuspendAll();
+        ws_flush_if_pending();
+        (void)xTaskResumeAll();
+    }
+}
+
+void vApplicationIdleHook(void){ __WFI(); }
+
+int main(void){
+    app_io_init();
+
+    static const char * const slv_name[] = { "slv0", "slv1" };
+    xTaskCreate(app_tx_task, "app", TASK_STACK, NULL, TASK_PRIO_APP, &s_wake_task[WAKE_APP_TX]);
+    for (uint8_t seg = 0; seg < SLV_SEGS; ++seg)
+        xTaskCreate(slave_tx_task, slv_name[seg], TASK_STACK, (void *)(uintptr_t)seg, TASK_PRIO_BUS,
+                    &s_wake_task[WAKE_SLV_TX + seg]);
+    xTaskCreate(bin_tx_task, "bin", TASK_STACK, NULL, TASK_PRIO_BUS, &s_wake_task[WAKE_BIN_TX]);
+    xTaskCreate(ws_task, "ws", TASK_STACK, NULL, TASK_PRIO_WS, &s_wake_task[WAKE_WS]);
+
+    vTaskStartScheduler();
+    for (;;) {}   // only reached if the heap is too small for the idle task
+}
+
+#endif /* APP_USE_FREERTOS */
@@ -6,26 +6,38 @@
  */
 
 #include "queues.h"
+#include "app_wake.h"
 #include <string.h>
 
-// UART1 queue
-static volatile uint8_t u1_head=0,u1_tail=0;
-volatile uint32_t u1_drops=0;
-static U1Frame u1_q[U1_TXQ_CAP];
+// Slave-bus queues (one SPSC ring per segment)
+typedef struct {
+    volatile uint8_t head, tail;
+    U1Frame q[U1_TXQ_CAP];
+} SlvRing;
+static SlvRing slv_q[SLV_SEGS];
+volatile uint32_t slv_drops[SLV_SEGS];
 
-bool u1q_push_isr(const uint8_t *d, uint8_t n){
-    const uint8_t next = (uint8_t)((u1_head + 1) % U1_TXQ_CAP);
-    if (next == u1_tail) { u1_drops++; return false; }
-    if (n > sizeof(u1_q[0].data)) n = sizeof(u1_q[0].data);
-    memcpy(u1_q[u1_head].data, d, n);
-    u1_q[u1_head].len = n; u1_head = next; return true;
+bool slvq_push_isr(uint8_t seg, const uint8_t *d, uint8_t n){
+    if (seg >= SLV_SEGS) return false;
+    SlvRing *r = &slv_q[seg];
+    const uint8_t next = (uint8_t)((r->head + 1) % U1_TXQ_CAP);
+    if (next == r->tail) { slv_drops[seg]++; return false; }
+    if (n > sizeof(r->q[0].data)) n = sizeof(r->q[0].data);
+    memcpy(r->q[r->head].data, d, n);
+    r->q[r->head].len = n; r->head = next;
+    app_wake_from_isr((uint8_t)(WAKE_SLV_TX + seg));
+    return true;
 }
-bool u1q_pop_main(U1Frame *out){
-    if (u1_tail == u1_head) return false;
-    *out = u1_q[u1_tail];
-    u1_tail = (uint8_t)((u1_tail + 1) % U1_TXQ_CAP);
+bool slvq_pop_main(uint8_t seg, U1Frame *out){
+    SlvRing *r = &slv_q[seg];
+    if (r->tail == r->head) return false;
+    *out = r->q[r->tail];
+    r->tail = (uint8_t)((r->tail + 1) % U1_TXQ_CAP);
     return true;
 }
+bool slvq_pending(uint8_t seg){
+    return seg < SLV_SEGS && slv_q[seg].tail != slv_q[seg].head;
+}
 
 // UART2 queue
 static volatile uint8_t u2_head=0,u2_tail=0;
@@ -37,7 +49,9 @@ bool u2q_push_isr(const uint8_t *d, uint8_t n){
     if (next == u2_tail) { u2_drops++; return false; }
     if (n > sizeof(u2_q[0].data)) { u2_drops++; return false; }
     memcpy(u2_q[u2_head].data, d, n);
-    u2_q[u2_head].len = n; u2_head = next; return true;
+    u2_q[u2_head].len = n; u2_head = next;
+    app_wake_from_isr(WAKE_BIN_TX);
+    return true;
 }
 bool u2q_pop_main(U2Frame *out){
     if (u2_tail == u2_head) return false;
@@ -45,4 +59,5 @@ bool u2q_pop_main(U2Frame *out){
     u2_tail = (uint8_t)((u2_tail + 1) % U2_TXQ_CAP);
     return true;
 }
+bool u2q_pending(void){ return u2_tail != u2_head; }
 
@@ -0,0 +1,37 @@
+/*
+ * slv_frame.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "slv_frame.h"
+#include "proto.h"
+
+enum { SF_WAIT_SOF = 0, SF_GOT_SOF, SF_WAIT_LEN, SF_COLLECT, SF_WAIT_END };
+
+static inline void sf_len(SlvFrameRx *f, uint8_t b){
+    f->len = b; f->idx = 0;
+    f->state = (!b || b > sizeof(f->pay)) ? SF_WAIT_SOF : SF_COLLECT;
+}
+
+uint8_t slv_frame_rx(SlvFrameRx *f, uint8_t b){
+    switch (f->state){
+    case SF_WAIT_SOF: if (b == SOF) f->state = SF_GOT_SOF; break;
+    case SF_GOT_SOF:
+        if (b == SOF) f->state = SF_WAIT_LEN;
+        else sf_len(f, b);
+        break;
+    case SF_WAIT_LEN: sf_len(f, b); break;
+    case SF_COLLECT:
+        f->pay[f->idx++] = b;
+        if (f->idx == f->len) f->state = SF_WAIT_END;
+        break;
+    case SF_WAIT_END:
+        f->state = SF_WAIT_SOF;
+        if (b == END_BYTE) return f->len;
+        break;
+    default: f->state = SF_WAIT_SOF; break;
+    }
+    return 0;
+}
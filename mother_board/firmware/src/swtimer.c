@@ -0,0 +1,86 @@
+/*
+ * swtimer.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "swtimer.h"
+
+#define SWT_MASK   (SWT_SLOTS - 1u)
+
+static SwTimer *s_l0[SWT_SLOTS];   // expires within the next SWT_SLOTS ticks
+static SwTimer *s_l1[SWT_SLOTS];   // by block of SWT_SLOTS ticks
+static uint32_t s_now;             // last tick processed
+
+// delta 0 only occurs while cascading, just before that tick's level-0 slot is run
+static void swt_link(SwTimer *t){
+    const int32_t delta = (int32_t)(t->expires - s_now);
+    SwTimer **head;
+    if (delta < 0)                          head = &s_l0[(s_now + 1u) & SWT_MASK];   // late: next tick
+    else if (delta < (int32_t)SWT_SLOTS)    head = &s_l0[t->expires & SWT_MASK];
+    else if (delta < (int32_t)(SWT_SLOTS * SWT_SLOTS)) head = &s_l1[(t->expires >> SWT_BITS) & SWT_MASK];
+    else                                    head = &s_l1[((s_now >> SWT_BITS) - 1u) & SWT_MASK];   // park, re-cascade
+    t->next = *head;
+    if (t->next) t->next->pprev = &t->next;
+    *head = t; t->pprev = head;
+}
+
+void swtimer_cancel(SwTimer *t){
+    if (!t->pprev) return;
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    t->next = NULL; t->pprev = NULL;
+}
+
+void swtimer_start(SwTimer *t, uint32_t ticks){
+    swtimer_cancel(t);
+    t->expires = s_now + (ticks ? ticks : 1u);
+    swt_link(t);
+}
+
+// Move a whole slot list onto `local`: the timers stay pending and cancellable there
+static void swt_take(SwTimer **head, SwTimer **local){
+    *local = *head;
+    *head = NULL;
+    if (*local) (*local)->pprev = local;
+}
+
+// Unlink the first timer of a list, NULL if empty
+static SwTimer *swt_pop(SwTimer **head){
+    SwTimer *t = *head;
+    if (!t) return NULL;
+    swtimer_cancel(t);
+    return t;
+}
+
+void swtimer_run(uint32_t now){
+    SwTimer *l, *t;
+    while (s_now != now){
+        ++s_now;
+        if (!(s_now & SWT_MASK)){
+            swt_take(&s_l1[(s_now >> SWT_BITS) & SWT_MASK], &l);
+            while ((t = swt_pop(&l))) swt_link(t);
+        }
+        // One timer at a time: a callback may cancel or restart any timer, including
+        // ones still waiting in `l`, and the rest of the slot is not lost
+        swt_take(&s_l0[s_now & SWT_MASK], &l);
+        while ((t = swt_pop(&l))){
+            if ((int32_t)(t->expires - s_now) > 0){ swt_link(t); continue; }
+            if (t->fn) t->fn(t);
+        }
+    }
+}
+
+uint32_t swtimer_ticks_to_next(uint32_t limit){
+    uint32_t best = limit;
+    for (uint32_t k = 1; k <= SWT_SLOTS && k < best; ++k)
+        if (s_l0[(s_now + k) & SWT_MASK]){ best = k; break; }
+    const uint32_t blk = s_now >> SWT_BITS;
+    for (uint32_t b = 1; b <= SWT_SLOTS; ++b){
+        const uint32_t k = ((blk + b) << SWT_BITS) - s_now;   // ticks to that block's cascade
+        if (k >= best) break;
+        if (s_l1[(blk + b) & SWT_MASK]){ best = k; break; }
+    }
+    return best;
+}
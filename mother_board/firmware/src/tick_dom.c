@@ -0,0 +1,82 @@
+/*
+ * tick_dom.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "tick_dom.h"
+#include "isr_rit.h"
+#include "chip.h"
+
+volatile uint8_t g_dom_period_ms[DOM_COUNT] = { DOM_SLV_MS, DOM_BIN_MS, DOM_WS_MS };
+static const uint8_t s_dom_min_ms[DOM_COUNT] = { DOM_SLV_MIN_MS, DOM_MIN_MS, DOM_MIN_MS };
+
+bool tick_dom_set_period(uint8_t dom, uint8_t ms){
+    if (dom >= DOM_COUNT) return false;
+    if (!ms) return true;
+    g_dom_period_ms[dom] = (ms < s_dom_min_ms[dom]) ? s_dom_min_ms[dom] : ms;
+    return true;
+}
+
+#if TICK_DOMAINS
+
+static void (* const s_dom_fn[DOM_COUNT])(void) = { dom_slv_tick, dom_bin_tick, dom_ws_tick };
+static uint32_t s_dom_next[DOM_COUNT];   // next match (µs, free-running TC)
+
+void tick_dom_init(void){
+    Chip_TIMER_Init(LPC_TIMER0);
+    Chip_TIMER_Reset(LPC_TIMER0);
+    Chip_TIMER_PrescaleSet(LPC_TIMER0, Chip_Clock_GetPeripheralClockRate(SYSCTL_PCLK_TIMER0) / 1000000u - 1u);
+    for (uint8_t d = 0; d < DOM_COUNT; ++d){
+        s_dom_next[d] = (uint32_t)g_dom_period_ms[d] * 1000u;
+        Chip_TIMER_SetMatch(LPC_TIMER0, d, s_dom_next[d]);
+        Chip_TIMER_MatchEnableInt(LPC_TIMER0, d);   // no reset on match: channels share the TC
+    }
+    NVIC_ClearPendingIRQ(TIMER0_IRQn);
+    NVIC_SetPriority(TIMER0_IRQn, IRQ_PRIO_RIT);
+    NVIC_EnableIRQ(TIMER0_IRQn);
+    Chip_TIMER_Enable(LPC_TIMER0);
+}
+
+static uint8_t s_dom_suspended;
+
+void tick_dom_suspend(void){
+    if (s_dom_suspended) return;
+    Chip_TIMER_Disable(LPC_TIMER0);
+    s_dom_suspended = 1;
+}
+
+void tick_dom_resume(void){
+    if (!s_dom_suspended) return;
+    const uint32_t tc = Chip_TIMER_ReadCount(LPC_TIMER0);
+    for (uint8_t d = 0; d < DOM_COUNT; ++d){
+        Chip_TIMER_ClearMatch(LPC_TIMER0, d);
+        s_dom_next[d] = tc + (uint32_t)g_dom_period_ms[d] * 1000u;
+        Chip_TIMER_SetMatch(LPC_TIMER0, d, s_dom_next[d]);
+    }
+    s_dom_suspended = 0;
+    Chip_TIMER_Enable(LPC_TIMER0);
+}
+
+void TIMER0_IRQHandler(void){
+    for (uint8_t d = 0; d < DOM_COUNT; ++d){
+        if (!Chip_TIMER_MatchPending(LPC_TIMER0, d)) continue;
+        Chip_TIMER_ClearMatch(LPC_TIMER0, d);
+        uint32_t next = s_dom_next[d] + (uint32_t)g_dom_period_ms[d] * 1000u;
+        // Overran (or the period was shortened): restart from now, never wait a TC wrap
+        const uint32_t tc = Chip_TIMER_ReadCount(LPC_TIMER0);
+        if ((int32_t)(next - tc) <= 0) next = tc + (uint32_t)g_dom_period_ms[d] * 1000u;
+        s_dom_next[d] = next;
+        Chip_TIMER_SetMatch(LPC_TIMER0, d, next);
+        s_dom_fn[d]();
+    }
+}
+
+#else
+
+void tick_dom_init(void){}
+void tick_dom_suspend(void){}
+void tick_dom_resume(void){}
+
+#endif /* TICK_DOMAINS */
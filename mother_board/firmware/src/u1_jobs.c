@@ -9,52 +9,207 @@
 #include "queues.h"
 #include "proto.h"
 #include "sched.h"
+#include "led_shadow.h"
+#include "app_status.h"
+#include "bitmap.h"
+#include "swtimer.h"
+#include "xact.h"
 
 volatile U1Job g_u1_jobs[MAX_U1_JOBS];
-uint8_t u1_jobs_rr = 0;
+volatile uint32_t g_u1_active;
+volatile U1MultiJob g_u1_multi;
 volatile bool g_led_streaming_active = false;
 
+// Active jobs whose deadline has come (a start, or their timer expired). The
+// others wait on s_u1_tmr[con] for their refresh / ack retry, or are disarmed.
+static uint32_t s_u1_due;
+static void u1_job_expired(SwTimer *t);
+static SwTimer s_u1_tmr[32] = { [0 ... 31] = SWTIMER_INIT(u1_job_expired) };
+
+static void u1_job_expired(SwTimer *t){ s_u1_due |= CONN_BIT((uint8_t)(t - s_u1_tmr)); }
+static inline void u1_job_disarm(uint8_t con){
+    s_u1_due &= ~CONN_BIT(con);
+    swtimer_cancel(&s_u1_tmr[con]);
+}
+
+// What each connector (1..31) last received, and what the multicast job last sent per segment
+static LedShadow s_u1_sent[32];
+static LedShadow s_u1_multi_sent[SLV_SEGS];
+static uint32_t  s_u1_multi_sent_mask[SLV_SEGS];
+
+#if LED_ACK_MODE
+volatile uint8_t g_u1_ack_led[32];   // LED each slave last reported; written by UART1 RX
+
+static inline bool u1_multi_unconfirmed(uint32_t mask, uint8_t led){
+    for (uint32_t m=mask; m; m &= m - 1) if (g_u1_ack_led[bitmap_first(m) + 1] != led) return true;
+    return false;
+}
+#endif
+
+static inline bool u1_con_due(uint8_t con, uint16_t now){
+    const uint8_t led = g_u1_jobs[con].led;
+#if LED_ACK_MODE
+    return led_shadow_due_acked(&s_u1_sent[con], led, g_u1_ack_led[con], now, g_u1_jobs[con].period);
+#else
+    return led_shadow_due(&s_u1_sent[con], led, now, g_u1_jobs[con].period);
+#endif
+}
+
+#if LED_ACK_MODE
+static void u1_job_rearm(uint8_t con);
+
+// LED-ON read-back finished. A slave that never confirmed waits a full ack
+// timeout from now, so polls keep their share of the segment.
+static void u1_led_xact_done(Xact *x, uint8_t result){
+    const uint8_t con = (uint8_t)(uintptr_t)x->ctx;
+    if (!(g_u1_active & CONN_BIT(con)) || g_u1_jobs[con].led != s_u1_sent[con].led) return;   // job moved on
+    if (result != XACT_DONE) s_u1_sent[con].tick = (uint16_t)g_tick;
+    u1_job_rearm(con);
+}
+#endif
+
 static inline void slave_enqueue_led_on(uint8_t con, uint8_t led){
     uint8_t f[9] = { SOF, GRP_RX_TO_SLV, 0x05, SC_SLAVE, con, 0x02, 0x01, led, END_BYTE };
-    (void)u1q_push_isr(f, sizeof f);
+    const uint8_t seg = con_seg(con);
+#if LED_ACK_MODE
+    // Send, await [SC_STATUS, con, st, led], retry; the segment is held meanwhile
+    if (xact_request(seg, f, sizeof f, SC_STATUS, con, XACT_RETRIES,
+                     u1_led_xact_done, (void *)(uintptr_t)con) != 0xFF){
+        (void)xact_run(seg);   // first try goes out this tick
+        return;
+    }
+#endif
+    (void)slvq_push_isr(seg, f, sizeof f);   // no ack wanted, or the pool is full
+}
+static inline void slave_enqueue_led_multi(uint8_t seg, uint32_t mask, uint8_t led){
+    uint8_t f[12] = { SOF, GRP_RX_TO_SLV, 0x08, SC_SLAVE, SLV_ADDR_BROADCAST, SLV_SUB_LED_MULTI,
+                      (uint8_t)mask, (uint8_t)(mask >> 8), (uint8_t)(mask >> 16), (uint8_t)(mask >> 24),
+                      led, END_BYTE };
+    (void)slvq_push_isr(seg, f, sizeof f);
 }
 
 void u1_jobs_clear_all(void){
-    for (uint8_t i=0;i<MAX_U1_JOBS;++i) g_u1_jobs[i].active = 0;
+    for (uint32_t m=g_u1_active; m; m &= m - 1) u1_job_disarm((uint8_t)(bitmap_first(m) + 1));
+    g_u1_active = 0;
+    g_u1_multi.mask = 0;
 }
 void u1_jobs_remove_by_con_except(uint8_t con, uint8_t keep_led){
-    for (uint8_t i=0;i<MAX_U1_JOBS;++i)
-        if (g_u1_jobs[i].active && g_u1_jobs[i].con==con && g_u1_jobs[i].led!=keep_led)
-            g_u1_jobs[i].active = 0;
+    if (con < 1 || con > 31) return;
+    // A per-connector job always takes over from the multicast job
+    g_u1_multi.mask &= ~CONN_BIT(con);
+    if ((g_u1_active & CONN_BIT(con)) && g_u1_jobs[con].led != keep_led){
+        g_u1_active &= ~CONN_BIT(con); u1_job_disarm(con);
+    }
 }
 uint8_t u1_job_find(uint8_t con, uint8_t led){
-    for (uint8_t i=0;i<MAX_U1_JOBS;++i)
-        if (g_u1_jobs[i].active && g_u1_jobs[i].con==con && g_u1_jobs[i].led==led) return i;
-    return 0xFF;
+    if (con < 1 || con > 31) return 0xFF;
+    return ((g_u1_active & CONN_BIT(con)) && g_u1_jobs[con].led == led) ? con : 0xFF;
 }
-uint8_t u1_job_alloc(uint8_t con, uint8_t led){
-    for (uint8_t i=0;i<MAX_U1_JOBS;++i)
-        if (!g_u1_jobs[i].active){ g_u1_jobs[i]=(U1Job){con,led,(uint16_t)g_tick,1}; return i; }
-    return 0xFF;
+uint8_t u1_job_start(uint8_t con, uint8_t led, uint8_t flags){
+    if (con < 1 || con > 31) return 0xFF;
+    const uint16_t lead = (flags & LEDF_URGENT) ? LED_URGENT_LEAD_TICKS : 0;
+    g_u1_jobs[con] = (U1Job){ led, flags, led_job_period(flags), (uint16_t)(g_tick - lead) };
+    if (flags & LEDF_ONESHOT) led_shadow_invalidate(&s_u1_sent[con]);   // explicit send
+    g_u1_active |= CONN_BIT(con);
+    swtimer_cancel(&s_u1_tmr[con]);
+    s_u1_due    |= CONN_BIT(con);
+    return con;
 }
 
-bool u1_scheduler_emit_one(void){
-    // Are there any active jobs?
-    g_led_streaming_active = false;
-    for (uint8_t i=0;i<MAX_U1_JOBS;++i){ if (g_u1_jobs[i].active){ g_led_streaming_active = true; break; } }
-    if (!g_led_streaming_active) return false;
+void u1_shadow_invalidate_all(void){
+    for (uint8_t c=0;c<32;++c){
+        led_shadow_invalidate(&s_u1_sent[c]);
+#if LED_ACK_MODE
+        g_u1_ack_led[c] = 0;   // wait for a fresh confirmation
+#endif
+    }
+    for (uint8_t g=0;g<SLV_SEGS;++g) led_shadow_invalidate(&s_u1_multi_sent[g]);
+    for (uint32_t m=g_u1_active; m; m &= m - 1){
+        const uint8_t con = (uint8_t)(bitmap_first(m) + 1);
+        g_u1_jobs[con].deadline = (uint16_t)g_tick;
+        swtimer_cancel(&s_u1_tmr[con]);
+    }
+    s_u1_due = g_u1_active;
+}
 
-    for (uint8_t k=0;k<MAX_U1_JOBS;++k){
-        const uint8_t i = (uint8_t)((u1_jobs_rr + k) % MAX_U1_JOBS);
-        if (!g_u1_jobs[i].active) continue;
-        const bool time_ok = ((int16_t)((uint16_t)g_tick - g_u1_jobs[i].next_allowed_tick) >= 0);
-        if (time_ok){
-            slave_enqueue_led_on(g_u1_jobs[i].con, g_u1_jobs[i].led);
-            g_u1_jobs[i].next_allowed_tick = (uint16_t)(g_tick + 1); // LED_JOB_MIN_PERIOD_TICKS
-            u1_jobs_rr = (uint8_t)((i + 1) % MAX_U1_JOBS);
-            return true;
+bool u1_jobs_due_any(void){ return s_u1_due != 0; }
+
+void u1_multi_add(uint32_t mask, uint8_t led){
+    if (g_u1_multi.led != led) g_u1_multi.mask = 0;
+    g_u1_multi.led  = led;
+    g_u1_multi.mask |= mask;
+}
+
+static bool u1_multi_emit_one(uint8_t seg, uint16_t now){
+    const uint32_t mask = g_u1_multi.mask & g_seg_conn_mask[seg];
+    if (!mask) return false;
+    LedShadow *msh = &s_u1_multi_sent[seg];
+    // Member set changed counts as a change of state
+    if (mask != s_u1_multi_sent_mask[seg]) led_shadow_invalidate(msh);
+#if LED_ACK_MODE
+    const uint8_t acked = u1_multi_unconfirmed(mask, g_u1_multi.led) ? 0 : g_u1_multi.led;
+    if (!led_shadow_due_acked(msh, g_u1_multi.led, acked, now, LED_KEEPALIVE_TICKS)) return false;
+#else
+    if (!led_shadow_due(msh, g_u1_multi.led, now, LED_KEEPALIVE_TICKS)) return false;
+#endif
+    slave_enqueue_led_multi(seg, mask, g_u1_multi.led);
+    led_shadow_sent(msh, g_u1_multi.led, now);
+    s_u1_multi_sent_mask[seg] = mask;
+    for (uint32_t m=mask; m; m &= m - 1) led_shadow_sent(&s_u1_sent[bitmap_first(m) + 1], g_u1_multi.led, now);
+    return true;
+}
+
+// Next deadline after a send, or after a check that found nothing to send:
+// the refresh period, or the ack timeout while unconfirmed. Nothing left to
+// wait for ⇒ disarm (and retire a one-shot job).
+static void u1_job_rearm(uint8_t con){
+    volatile U1Job *j = &g_u1_jobs[con];
+    uint16_t wait = j->period;
+#if LED_ACK_MODE
+    if (g_u1_ack_led[con] != j->led && (!wait || wait > LED_ACK_TIMEOUT_TICKS)) wait = LED_ACK_TIMEOUT_TICKS;
+#endif
+    if (!wait){
+        u1_job_disarm(con);
+        if (j->flags & LEDF_ONESHOT) g_u1_active &= ~CONN_BIT(con);
+        return;
+    }
+    j->deadline = (uint16_t)(s_u1_sent[con].tick + wait);
+    const int16_t in = (int16_t)(j->deadline - (uint16_t)g_tick);
+    if (in <= 0){ s_u1_due |= CONN_BIT(con); return; }
+    s_u1_due &= ~CONN_BIT(con);
+    swtimer_start(&s_u1_tmr[con], (uint32_t)in);
+}
+
+// Earliest deadline first over the due jobs of a segment; ties go to urgent jobs
+static uint8_t u1_edf_pick(uint32_t cand, uint16_t now){
+    uint8_t best = 0xFF; int16_t best_late = 0; bool best_urg = false;
+    for (uint32_t m=cand; m; m &= m - 1){
+        const uint8_t con = (uint8_t)(bitmap_first(m) + 1);
+        const int16_t late = (int16_t)(now - g_u1_jobs[con].deadline);
+        if (!u1_con_due(con, now)){ u1_job_rearm(con); continue; }   // shadow still current
+        const bool urg = (g_u1_jobs[con].flags & LEDF_URGENT) != 0;
+        if (best == 0xFF || late > best_late || (late == best_late && urg && !best_urg)){
+            best = con; best_late = late; best_urg = urg;
         }
     }
-    return false;
+    return best;
 }
 
+bool u1_scheduler_emit_one(uint8_t seg){
+    // Are there any active jobs?
+    g_led_streaming_active = ((g_u1_active | g_u1_multi.mask) != 0);
+    if (!g_led_streaming_active) return false;
+
+    // Only targets whose desired LED differs from the last one sent (or whose
+    // refresh period expired) go on the wire; otherwise the tick is left to polling.
+    const uint16_t now = (uint16_t)g_tick;
+    if (u1_multi_emit_one(seg, now)) return true;
+
+    const uint8_t con = u1_edf_pick(s_u1_due & g_seg_conn_mask[seg], now);
+    if (con == 0xFF) return false;
+    const uint8_t led = g_u1_jobs[con].led;
+    slave_enqueue_led_on(con, led);
+    led_shadow_sent(&s_u1_sent[con], led, now);
+    u1_job_rearm(con);
+    return true;
+}
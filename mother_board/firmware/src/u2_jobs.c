@@ -9,6 +9,10 @@
 #include "queues.h"
 #include "proto.h"
 #include "sched.h"
+#include "led_shadow.h"
+#include "bitmap.h"
+#include "swtimer.h"
+#include "xact.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>   // for memset
@@ -18,8 +22,49 @@
 #define U2_MAX_MASK_LEN 120
 #endif
 
+#if MAX_BIN > 32
+#error "MAX_BIN must fit the 32-bit job bitmaps"
+#endif
+
+#define BIN_BIT(b) (1u << ((b) - 1))
+
 volatile U2Job g_u2_jobs[MAX_U2_JOBS];
-uint8_t u2_jobs_rr = 0;
+volatile uint32_t g_u2_active;
+
+// Active jobs whose deadline has come; the others wait on s_u2_tmr[bin] (see u1_jobs.c)
+static uint32_t s_u2_due;
+static void u2_job_expired(SwTimer *t);
+static SwTimer s_u2_tmr[MAX_BIN + 1] = { [0 ... MAX_BIN] = SWTIMER_INIT(u2_job_expired) };
+
+static void u2_job_expired(SwTimer *t){ s_u2_due |= BIN_BIT((uint8_t)(t - s_u2_tmr)); }
+static inline void u2_job_disarm(uint8_t bin){
+    s_u2_due &= ~BIN_BIT(bin);
+    swtimer_cancel(&s_u2_tmr[bin]);
+}
+
+// Last LED sent per BIN id (1..MAX_BIN)
+static LedShadow s_u2_sent[MAX_BIN + 1];
+
+#if LED_ACK_MODE
+volatile uint8_t g_u2_ack_led[MAX_BIN + 1];   // written by UART2 RX
+#endif
+
+void u2_shadow_invalidate_all(void){
+    for (uint8_t b=0;b<=MAX_BIN;++b){
+        led_shadow_invalidate(&s_u2_sent[b]);
+#if LED_ACK_MODE
+        g_u2_ack_led[b] = 0;
+#endif
+    }
+    for (uint32_t m=g_u2_active; m; m &= m - 1){
+        const uint8_t bin = (uint8_t)(bitmap_first(m) + 1);
+        g_u2_jobs[bin].deadline = (uint16_t)g_tick;
+        swtimer_cancel(&s_u2_tmr[bin]);
+    }
+    s_u2_due = g_u2_active;
+}
+
+bool u2_jobs_due_any(void){ return s_u2_due != 0; }
 
 /* Normalize to 1..60 (61->1, 63->3, 120->60); 0 stays 0. */
 static inline uint8_t u2_norm_led(uint8_t led) {
@@ -28,51 +73,94 @@ static inline uint8_t u2_norm_led(uint8_t led) {
     return (uint8_t)(led - 60);
 }
 
+#if LED_ACK_MODE
+// BIN slaves report the normalized (1..60) LED they show
+static inline bool u2_bin_acked(uint8_t bin){
+    return g_u2_ack_led[bin] == u2_norm_led(g_u2_jobs[bin].led);
+}
+#endif
+
+static inline bool u2_bin_due(uint8_t bin, uint16_t now){
+    const uint8_t led = g_u2_jobs[bin].led;
+#if LED_ACK_MODE
+    return led_shadow_due_acked(&s_u2_sent[bin], led, u2_bin_acked(bin) ? led : 0, now, g_u2_jobs[bin].period);
+#else
+    return led_shadow_due(&s_u2_sent[bin], led, now, g_u2_jobs[bin].period);
+#endif
+}
+
 /* ---------------- Job table ops ---------------- */
 
-void u2_job_start(uint8_t bin, uint8_t led){
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i){
-        if (g_u2_jobs[i].active && g_u2_jobs[i].bin==bin && g_u2_jobs[i].led==led){
-            g_u2_jobs[i].next_allowed_tick = (uint16_t)g_tick; return;
-        }
-    }
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i){
-        if (!g_u2_jobs[i].active){ g_u2_jobs[i]=(U2Job){bin,led,(uint16_t)g_tick,1}; return; }
-    }
+static inline bool bin_ok(uint8_t bin){ return bin >= 1 && bin <= MAX_BIN; }
+
+uint8_t u2_job_start(uint8_t bin, uint8_t led, uint8_t flags){
+    if (!bin_ok(bin)) return 0xFF;
+    const uint16_t lead = (flags & LEDF_URGENT) ? LED_URGENT_LEAD_TICKS : 0;
+    g_u2_jobs[bin] = (U2Job){ led, flags, led_job_period(flags), (uint16_t)(g_tick - lead) };
+    if (flags & LEDF_ONESHOT) led_shadow_invalidate(&s_u2_sent[bin]);   // explicit send
+    g_u2_active |= BIN_BIT(bin);
+    swtimer_cancel(&s_u2_tmr[bin]);
+    s_u2_due    |= BIN_BIT(bin);
+    return bin;
 }
 
 void u2_jobs_stop_by_led(uint8_t led){
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i)
-        if (g_u2_jobs[i].active && g_u2_jobs[i].led==led) g_u2_jobs[i].active=0;
+    for (uint32_t m=g_u2_active; m; m &= m - 1){
+        const uint8_t bin = (uint8_t)(bitmap_first(m) + 1);
+        if (g_u2_jobs[bin].led == led){ g_u2_active &= ~BIN_BIT(bin); u2_job_disarm(bin); }
+    }
 }
 
 void u2_jobs_stop_all(void){
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i) g_u2_jobs[i].active=0;
+    for (uint32_t m=g_u2_active; m; m &= m - 1) u2_job_disarm((uint8_t)(bitmap_first(m) + 1));
+    g_u2_active = 0;
 }
 
 void u2_jobs_remove_by_bin_except(uint8_t bin, uint8_t keep_led){
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i)
-        if (g_u2_jobs[i].active && g_u2_jobs[i].bin==bin && g_u2_jobs[i].led!=keep_led) g_u2_jobs[i].active=0;
+    if (bin_ok(bin) && (g_u2_active & BIN_BIT(bin)) && g_u2_jobs[bin].led != keep_led){
+        g_u2_active &= ~BIN_BIT(bin); u2_job_disarm(bin);
+    }
 }
 
 uint8_t u2_job_find(uint8_t bin, uint8_t led){
-    for (uint8_t i=0;i<MAX_U2_JOBS;++i)
-        if (g_u2_jobs[i].active && g_u2_jobs[i].bin==bin && g_u2_jobs[i].led==led) return i;
-    return 0xFF;
+    if (!bin_ok(bin)) return 0xFF;
+    return ((g_u2_active & BIN_BIT(bin)) && g_u2_jobs[bin].led == led) ? bin : 0xFF;
 }
 
 /* ---------------- UART2 frame enqueue ---------------- */
 
+#if LED_ACK_MODE
+static void u2_job_rearm(uint8_t bin);
+
+// LED-ON read-back finished; same rules as u1_led_xact_done()
+static void u2_led_xact_done(Xact *x, uint8_t result){
+    const uint8_t bin = (uint8_t)(uintptr_t)x->ctx;
+    if (!(g_u2_active & BIN_BIT(bin)) || g_u2_jobs[bin].led != s_u2_sent[bin].led) return;
+    if (result != XACT_DONE) s_u2_sent[bin].tick = (uint16_t)g_tick;
+    u2_job_rearm(bin);
+}
+#endif
+
 void bin_enqueue_led_on_uart2(uint8_t bin, uint8_t led){
     /* Single LED path keeps your previous normalization behavior. */
     led = u2_norm_led(led);
     uint8_t f[9] = { SOF, GRP_RX_TO_SLV, 0x05, SC_SLAVE, bin, 0x04, 0x01, led, END_BYTE };
+#if LED_ACK_MODE
+    /* Send, await [SC_STATUS, bin, st, led], retry; UART2 is held meanwhile */
+    if (xact_request(XACT_BUS_BIN, f, sizeof f, SC_STATUS, bin, XACT_RETRIES,
+                     u2_led_xact_done, (void *)(uintptr_t)bin) != 0xFF){
+        (void)xact_run(XACT_BUS_BIN);
+        return;
+    }
+#endif
     (void)u2q_push_isr(f, sizeof f);
 }
 
 void bin_enqueue_led_off_broadcast_uart2(void){
     uint8_t f[8] = { SOF, GRP_RX_TO_SLV, 0x04, SC_SLAVE, 0xFF, 0x03, 0x00, END_BYTE };
+    xact_cancel_seg(XACT_BUS_BIN);   // no stale LED-ON retry after the OFF
     (void)u2q_push_isr(f, sizeof f);
+    u2_shadow_invalidate_all();
 }
 
 /* Helper: send a multi-mask frame with a prepared payload (zeros = skip) */
@@ -136,18 +224,43 @@ void bin_enqueue_multi_mask_uart2(uint8_t max_led, const uint8_t *list){
 
 /* ---------------- Scheduler ---------------- */
 
+// Same deadline rules as u1_jobs.c: refresh period, or ack timeout while unconfirmed
+static void u2_job_rearm(uint8_t bin){
+    volatile U2Job *j = &g_u2_jobs[bin];
+    uint16_t wait = j->period;
+#if LED_ACK_MODE
+    if (!u2_bin_acked(bin) && (!wait || wait > LED_ACK_TIMEOUT_TICKS)) wait = LED_ACK_TIMEOUT_TICKS;
+#endif
+    if (!wait){
+        u2_job_disarm(bin);
+        if (j->flags & LEDF_ONESHOT) g_u2_active &= ~BIN_BIT(bin);
+        return;
+    }
+    j->deadline = (uint16_t)(s_u2_sent[bin].tick + wait);
+    const int16_t in = (int16_t)(j->deadline - (uint16_t)g_tick);
+    if (in <= 0){ s_u2_due |= BIN_BIT(bin); return; }
+    s_u2_due &= ~BIN_BIT(bin);
+    swtimer_start(&s_u2_tmr[bin], (uint32_t)in);
+}
+
 bool u2_scheduler_emit_one(void){
-    for (uint8_t k=0;k<MAX_U2_JOBS;++k){
-        const uint8_t i = (uint8_t)((u2_jobs_rr + k) % MAX_U2_JOBS);
-        if (!g_u2_jobs[i].active) continue;
-
-        const bool time_ok = ((int16_t)((uint16_t)g_tick - g_u2_jobs[i].next_allowed_tick) >= 0);
-        if (time_ok){
-            bin_enqueue_led_on_uart2(g_u2_jobs[i].bin, g_u2_jobs[i].led);
-            g_u2_jobs[i].next_allowed_tick = (uint16_t)(g_tick + 1);
-            u2_jobs_rr = (uint8_t)((i + 1) % MAX_U2_JOBS);
-            return true;
+    // Change-only (led_shadow.h), earliest deadline first; ties go to urgent jobs
+    const uint16_t now = (uint16_t)g_tick;
+    uint8_t best = 0xFF; int16_t best_late = 0; bool best_urg = false;
+    for (uint32_t m=s_u2_due; m; m &= m - 1){
+        const uint8_t bin = (uint8_t)(bitmap_first(m) + 1);
+        const int16_t late = (int16_t)(now - g_u2_jobs[bin].deadline);
+        if (!u2_bin_due(bin, now)){ u2_job_rearm(bin); continue; }
+        const bool urg = (g_u2_jobs[bin].flags & LEDF_URGENT) != 0;
+        if (best == 0xFF || late > best_late || (late == best_late && urg && !best_urg)){
+            best = bin; best_late = late; best_urg = urg;
         }
     }
-    return false;
+    if (best == 0xFF) return false;
+
+    const uint8_t led = g_u2_jobs[best].led;
+    bin_enqueue_led_on_uart2(best, led);
+    led_shadow_sent(&s_u2_sent[best], led, now);
+    u2_job_rearm(best);
+    return true;
 }
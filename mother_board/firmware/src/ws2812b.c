@@ -1,52 +1,54 @@
 #include "../../firmware/inc/ws2812b.h"
 
+#include "config.h"
 #include "chip.h"
 #include "board.h"
 
 /*------------------------------------------------------------------------------
  * Low-level WS2812B bit-banging functions (timing critical)
+ *
+ * Edges are paced against the DWT cycle counter (enabled in app_io_init()),
+ * with every interval converted to core cycles at compile time from
+ * WS_CORE_CLOCK_HZ, so timing holds at any clock and optimization level.
  *----------------------------------------------------------------------------*/
 
-/**
- * @brief Send a logic '0' to WS2812B.
- * Timing: T0H ≈ 400 ns, T0L ≈ 850 ns
- */
-static inline void send_zero(void) {
-
-	LPC_GPIO[3].SET = LED_MASK;
+#define WS_NS_TO_CYC(ns)  ((uint32_t)(((uint64_t)(ns) * WS_CORE_CLOCK_HZ + 999999999ULL) / 1000000000ULL))
 
-    /* High ~420 ns (16 NOPs at 100 MHz) */
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
+#define WS_T0H_CYC    WS_NS_TO_CYC(400)     /* '0' high */
+#define WS_T1H_CYC    WS_NS_TO_CYC(800)     /* '1' high */
+#define WS_BIT_CYC    WS_NS_TO_CYC(1250)    /* full bit period */
+#define WS_RESET_CYC  WS_NS_TO_CYC(64000)   /* latch, as the DMA backends */
 
-    LPC_GPIO[3].CLR = LED_MASK;
+/* A DWT poll takes a few cycles; below this the edges land too coarsely */
+#if WS_CORE_CLOCK_HZ < 48000000UL
+#error "WS_CORE_CLOCK_HZ too low to pace WS2812 edges with DWT"
+#endif
 
-    /* Low ~800 ns (25 NOPs at 100 MHz) */
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();
+static inline void ws_wait_cyc(uint32_t t, uint32_t cyc) {
+    while ((DWT->CYCCNT - t) < cyc) {}
 }
 
 /**
- * @brief Send a logic '1' to WS2812B.
- * Timing: T1H ≈ 800 ns, T1L ≈ 450 ns
+ * @brief Send one bit period on several lanes, starting no earlier than `t`.
+ * All lanes high; `zeros` drop at T0H, the rest at T1H.
+ * A late start (mask computation ran long) moves the bit, never shortens its low time.
+ * @return Earliest start of the next bit.
  */
-static inline void send_one(void) {
+static inline uint32_t send_lanes(uint32_t t, uint32_t all, uint32_t zeros) {
+    while ((int32_t)(DWT->CYCCNT - t) < 0) {}
+    t = DWT->CYCCNT;
 
-	 LPC_GPIO[3].SET = LED_MASK;
+    LPC_GPIO[3].SET = all;
+    ws_wait_cyc(t, WS_T0H_CYC);
+    LPC_GPIO[3].CLR = zeros;
+    ws_wait_cyc(t, WS_T1H_CYC);
+    LPC_GPIO[3].CLR = all;
 
-    /* High ~800 ns (36 NOPs at 100 MHz) */
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
-
-    LPC_GPIO[3].CLR = LED_MASK;
+    return t + WS_BIT_CYC;
+}
 
-    /* Low ~420 ns (8 NOPs at 100 MHz) */
-    __NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();__NOP();
+static inline void send_reset(uint32_t t) {
+    ws_wait_cyc(t, WS_RESET_CYC);
 }
 
 /**
@@ -68,30 +70,48 @@ void turnOnRed(WS2812B* ws2812b, int bin_led_num) {
  * Data is sent in GRB order per WS2812B protocol.
  */
 void WS2812B_write(WS2812B* ws2812b) {
+    uint32_t t = DWT->CYCCNT;
     for (uint16_t i = 0; i < ws2812b->num_leds; i++) {
-        RGB_t led = ws2812b->leds[i];
+        const RGB_t led = ws2812b->leds[i];
+        const uint32_t grb = ((uint32_t)led.g << 16) | ((uint32_t)led.r << 8) | led.b;
 
-        /* Send Green */
-        for (uint8_t bit = 0; bit < 8; bit++) {
-            (led.g & 0x80) ? send_one() : send_zero();
-            led.g <<= 1;
+        for (uint32_t bit = 1UL << 23; bit; bit >>= 1) {
+            t = send_lanes(t, LED_MASK, (grb & bit) ? 0 : LED_MASK);
         }
+    }
 
-        /* Send Red */
-        for (uint8_t bit = 0; bit < 8; bit++) {
-            (led.r & 0x80) ? send_one() : send_zero();
-            led.r <<= 1;
+    /* Reset pulse (>50 µs) */
+    send_reset(t);
+}
+
+/**
+ * @brief Write several strips in one pass (GRB order, one index buffer per lane).
+ */
+void WS2812B_write_lanes(const uint32_t *const *fb, uint8_t bits, const RGB_t *pal,
+                         const uint32_t *pin_masks, uint8_t lanes, uint16_t num_leds) {
+    if (lanes > WS2812B_MAX_LANES) lanes = WS2812B_MAX_LANES;
+    const uint32_t idx_mask = (1UL << bits) - 1UL;
+    uint32_t all = 0;
+    for (uint8_t l = 0; l < lanes; l++) all |= pin_masks[l];
+
+    uint32_t t = DWT->CYCCNT;
+    for (uint16_t i = 0; i < num_leds; i++) {
+        const uint32_t pos = (uint32_t)i * bits;
+        uint32_t grb[WS2812B_MAX_LANES];
+        for (uint8_t l = 0; l < lanes; l++) {
+            const RGB_t led = pal[(fb[l][pos >> 5] >> (pos & 31u)) & idx_mask];
+            grb[l] = ((uint32_t)led.g << 16) | ((uint32_t)led.r << 8) | led.b;
         }
 
-        /* Send Blue */
-        for (uint8_t bit = 0; bit < 8; bit++) {
-            (led.b & 0x80) ? send_one() : send_zero();
-            led.b <<= 1;
+        for (uint32_t bit = 1UL << 23; bit; bit >>= 1) {
+            uint32_t zeros = 0;
+            for (uint8_t l = 0; l < lanes; l++) {
+                if (!(grb[l] & bit)) zeros |= pin_masks[l];
+            }
+            t = send_lanes(t, all, zeros);
         }
     }
 
-    /* Reset pulse (>50 µs). Approximate using raw NOPs */
-    for (uint16_t i = 0; i < 600; i++) {
-        __NOP(); __NOP();
-    }
+    /* Reset pulse (>50 µs) */
+    send_reset(t);
 }
@@ -0,0 +1,62 @@
+/*
+ * ws_hw_bitbang.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ *
+ *  WS_BACKEND_BITBANG: ws2812b.c DWT-paced timing with PRIMASK set for the frame.
+ */
+
+#include "ws_hw.h"
+#include "ws_pal.h"
+
+#if WS_BACKEND == WS_BACKEND_BITBANG
+
+#if WS_LED_COUNT > 255
+#error "bit-bang masks IRQs ~30 us per LED: long strips overrun the UART FIFOs, use WS_BACKEND_SSP_DMA or _TIMER_DMA"
+#endif
+
+static inline uint32_t primask_save_and_disable(void){
+    uint32_t primask;
+    __asm volatile ("MRS %0, PRIMASK" : "=r"(primask) ::);
+    __asm volatile ("cpsid i" ::: "memory");
+    return primask;
+}
+static inline void primask_restore(uint32_t primask){
+    if ((primask & 1u) == 0u){
+        __asm volatile ("cpsie i" ::: "memory");
+    }
+}
+
+static bool s_ws_clk_ok;   /* core runs at the clock the edge timing was built for */
+
+/* WS_CORE_CLOCK_HZ is a compile-time constant: if the PLL setup disagrees
+   (SystemCoreClockUpdate() ran in app_io_init()), every edge would be off and
+   the strip would decode garbage, so the output stays dark instead. */
+void ws_hw_init(void){
+    s_ws_clk_ok = (SystemCoreClock == WS_CORE_CLOCK_HZ);
+}
+
+bool ws_hw_busy(void){ return false; }
+
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c){ (void)lane; (void)idx; (void)c; }   /* encoded at write */
+
+static const uint32_t s_ws_pins[WS_STRIPS] = {
+    LED_PIN_STRIP1,
+#if WS_STRIPS > 1
+    LED_PIN_STRIP2,
+#endif
+};
+
+/* Prevent any ISR from jittering the WS2812 bitstream.
+   ~3.6 ms per 120 LEDs @800 kHz, all lanes at once. */
+void ws_hw_write(const uint32_t *const *lanes, uint16_t n){
+    if (!s_ws_clk_ok) return;
+    uint32_t ps = primask_save_and_disable();
+
+    WS2812B_write_lanes(lanes, WS_PAL_BITS, g_ws_pal, s_ws_pins, WS_STRIPS, n);
+
+    primask_restore(ps);
+}
+
+#endif /* WS_BACKEND_BITBANG */
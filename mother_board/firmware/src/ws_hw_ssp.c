@@ -0,0 +1,198 @@
+/*
+ * ws_hw_ssp.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ *
+ *  WS_BACKEND_SSP_DMA: WS2812 frames as SPI symbols, one SSP per strip
+ *  (lane 0: SSP0 MOSI P0.18, lane 1: SSP1 MOSI P0.9).
+ *   - 2.5 MHz SPI clock: one SPI bit = 400 ns, one WS bit = 3 SPI bits (1.2 µs)
+ *     0 -> 100 (T0H 400 ns), 1 -> 110 (T1H 800 ns)
+ *   - The encoded stream (9 bytes per LED, GRB) is kept current by
+ *     ws_hw_set_px(): one table lookup per color byte
+ *   - A flush is two GPDMA descriptors: the stream prefix, then
+ *     WS_SSP_LATCH_BYTES zero bytes for the reset
+ *   - WS_DMA_STREAM: no frame-sized stream. Chunks of WS_DMA_CHUNK_LEDS
+ *     are encoded from the palette front buffer into two buffers whose
+ *     descriptors point at each other; each chunk's terminal count refills
+ *     the buffer it just freed with the chunk after next. The last chunk
+ *     links to the latch.
+ *   - CPHA=1: the SSP sends back-to-back frames without the SSEL gap it
+ *     inserts between frames with CPHA=0, so symbols stay contiguous
+ */
+
+#include "ws_hw.h"
+
+#if WS_BACKEND == WS_BACKEND_SSP_DMA
+
+#include "chip.h"
+#include "ws_pal.h"
+
+#define WS_SSP_BITRATE       2500000u
+#ifndef WS_SSP_LATCH_BYTES
+#define WS_SSP_LATCH_BYTES   20          /* 20 × 3.2 µs = 64 µs low (> 50 µs reset) */
+#endif
+#if WS_DMA_STREAM
+#define WS_SSP_BYTES         (WS_DMA_CHUNK_LEDS * 9)   /* per ping-pong buffer */
+#else
+#define WS_SSP_BYTES         (WS_LED_COUNT * 9)
+#endif
+
+#if WS_SSP_BYTES > 4095
+#error "WS_LED_COUNT too large for one GPDMA transfer (4095 bytes): set WS_DMA_STREAM"
+#endif
+
+/* One color byte -> eight 3-bit symbols (24 bits, MSB first), built at compile time */
+#define WS_SYM(b)  ((b) ? 6u : 4u)
+#define WS_NIB(n)  ((WS_SYM((n) & 8) << 9) | (WS_SYM((n) & 4) << 6) | (WS_SYM((n) & 2) << 3) | WS_SYM((n) & 1))
+#define WS_B(v)    (((uint32_t)WS_NIB((v) >> 4) << 12) | WS_NIB((v) & 15))
+#define WS_B4(v)   WS_B(v), WS_B((v) + 1), WS_B((v) + 2), WS_B((v) + 3)
+#define WS_B16(v)  WS_B4(v), WS_B4((v) + 4), WS_B4((v) + 8), WS_B4((v) + 12)
+#define WS_B64(v)  WS_B16(v), WS_B16((v) + 16), WS_B16((v) + 32), WS_B16((v) + 48)
+static const uint32_t s_ws_sym[256] = { WS_B64(0), WS_B64(64), WS_B64(128), WS_B64(192) };
+
+typedef struct {
+    LPC_SSP_T *ssp;
+    uint8_t    mosi_port, mosi_pin, dma_req;
+} WsLane;
+
+static const WsLane s_ws_lane[WS_STRIPS] = {
+    { LPC_SSP0, 0, 18, GPDMA_CONN_SSP0_Tx },
+#if WS_STRIPS > 1
+    { LPC_SSP1, 0,  9, GPDMA_CONN_SSP1_Tx },
+#endif
+};
+
+/* Byte-wide, bursts of 4 into the 8-entry TX FIFO */
+#define WS_SSP_DMA_CTRL(n)  (GPDMA_DMACCxControl_TransferSize((n)) | GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_4) \
+                            | GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_4) | GPDMA_DMACCxControl_SI)
+
+WS_DMA_RAM static uint8_t s_ws_latch[WS_SSP_LATCH_BYTES];     /* stays zero */
+WS_DMA_RAM static DMA_TransferDescriptor_t s_ws_tail[WS_STRIPS];   /* latch, chained behind the stream */
+static uint8_t s_ws_dma_ch[WS_STRIPS];
+#if WS_DMA_STREAM
+WS_DMA_RAM static uint8_t s_ws_tx[WS_STRIPS][2][WS_SSP_BYTES];
+WS_DMA_RAM static DMA_TransferDescriptor_t s_ws_lli[WS_STRIPS][2];   /* one per buffer */
+static const uint32_t *s_ws_src[WS_STRIPS];   /* front buffer being sent */
+static uint16_t s_ws_n;                       /* LEDs in the frame */
+static uint16_t s_ws_next[WS_STRIPS];         /* next chunk to encode */
+#else
+WS_DMA_RAM static uint8_t s_ws_tx[WS_STRIPS][WS_SSP_BYTES];
+#endif
+
+static inline uint8_t *ws_enc_byte(uint8_t *o, uint8_t v){
+    const uint32_t bits = s_ws_sym[v];
+    o[0] = (uint8_t)(bits >> 16); o[1] = (uint8_t)(bits >> 8); o[2] = (uint8_t)bits;
+    return o + 3;
+}
+
+static inline void ws_enc_px(uint8_t *o, RGB_t c){
+    o = ws_enc_byte(o, c.g);
+    o = ws_enc_byte(o, c.r);
+    (void)ws_enc_byte(o, c.b);
+}
+
+#if WS_DMA_STREAM
+
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c){ (void)lane; (void)idx; (void)c; }   /* encoded per chunk */
+
+/* Encode chunk j into its buffer and point its descriptor at the next chunk (or the latch) */
+static void ws_chunk_fill(uint8_t l, uint16_t j){
+    const uint16_t first = (uint16_t)(j * WS_DMA_CHUNK_LEDS), len = ws_chunk_len(j, s_ws_n);
+    uint8_t * const buf = s_ws_tx[l][j & 1u];
+    for (uint16_t i = 0; i < len; ++i) ws_enc_px(&buf[i * 9u], g_ws_pal[ws_pal_get(s_ws_src[l], (uint16_t)(first + i))]);
+
+    const bool last = (uint16_t)(j + 1u) >= ws_chunks(s_ws_n);
+    s_ws_lli[l][j & 1u] = (DMA_TransferDescriptor_t){
+        (uint32_t)(uintptr_t)buf, (uint32_t)(uintptr_t)&s_ws_lane[l].ssp->DR,
+        last ? (uint32_t)(uintptr_t)&s_ws_tail[l] : (uint32_t)(uintptr_t)&s_ws_lli[l][(j + 1u) & 1u],
+        WS_SSP_DMA_CTRL((uint32_t)len * 9u) | GPDMA_DMACCxControl_I };
+}
+
+/* Chunk k done: its buffer takes chunk k + 2 while k + 1 is on the wire */
+void DMA_IRQHandler(void){
+    for (uint8_t l = 0; l < WS_STRIPS; ++l){
+        const uint32_t bit = 1u << s_ws_dma_ch[l];
+        if (!(LPC_GPDMA->INTTCSTAT & bit)) continue;
+        LPC_GPDMA->INTTCCLEAR = bit;
+        if (s_ws_next[l] < ws_chunks(s_ws_n)) ws_chunk_fill(l, s_ws_next[l]++);
+    }
+}
+
+#else
+
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c){
+    if (lane >= WS_STRIPS || idx >= WS_LED_COUNT) return;
+    ws_enc_px(&s_ws_tx[lane][idx * 9u], c);
+}
+
+#endif /* WS_DMA_STREAM */
+
+void ws_hw_init(void){
+    Chip_GPDMA_Init(LPC_GPDMA);
+    for (uint8_t l = 0; l < WS_STRIPS; ++l){
+        const WsLane *ln = &s_ws_lane[l];
+        Chip_IOCON_PinMuxSet(LPC_IOCON, ln->mosi_port, ln->mosi_pin, IOCON_MODE_INACT | IOCON_FUNC2);
+
+        Chip_SSP_Init(ln->ssp);
+        Chip_SSP_SetFormat(ln->ssp, SSP_BITS_8, SSP_FRAMEFORMAT_SPI, SSP_CLOCK_CPHA1_CPOL0);
+        Chip_SSP_SetBitRate(ln->ssp, WS_SSP_BITRATE);
+        Chip_SSP_Enable(ln->ssp);
+        Chip_SSP_DMA_Enable(ln->ssp);
+
+        s_ws_dma_ch[l] = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, ln->dma_req);   /* kept for good */
+        s_ws_tail[l] = (DMA_TransferDescriptor_t){ (uint32_t)(uintptr_t)s_ws_latch,
+                                                   (uint32_t)(uintptr_t)&ln->ssp->DR, 0,
+                                                   WS_SSP_DMA_CTRL(WS_SSP_LATCH_BYTES) };
+
+#if !WS_DMA_STREAM
+        for (uint16_t i = 0; i < WS_LED_COUNT; ++i) ws_hw_set_px(l, i, (RGB_t){ 0, 0, 0 });
+#endif
+    }
+#if WS_DMA_STREAM
+    NVIC_SetPriority(DMA_IRQn, IRQ_PRIO_WS_DMA);
+    NVIC_EnableIRQ(DMA_IRQn);
+#endif
+}
+
+bool ws_hw_busy(void){
+    for (uint8_t l = 0; l < WS_STRIPS; ++l){
+        if (Chip_GPDMA_IntGetStatus(LPC_GPDMA, GPDMA_STAT_ENABLED_CH, s_ws_dma_ch[l]) == SET) return true;
+        if (Chip_SSP_GetStatus(s_ws_lane[l].ssp, SSP_STAT_BSY) == SET) return true;
+    }
+    return false;
+}
+
+#if WS_DMA_STREAM
+
+/* Two chunks encoded up front; the DMA interrupt keeps one chunk ahead */
+void ws_hw_write(const uint32_t *const *lanes, uint16_t n){
+    if (n > WS_LED_COUNT) n = WS_LED_COUNT;
+    if (!n) return;
+    s_ws_n = n;
+    for (uint8_t l = 0; l < WS_STRIPS; ++l){
+        s_ws_src[l] = lanes[l];
+        ws_chunk_fill(l, 0);
+        if (ws_chunks(n) > 1) ws_chunk_fill(l, 1);
+        s_ws_next[l] = 2;
+        const DMA_TransferDescriptor_t *d = &s_ws_lli[l][0];
+        ws_dma_start(s_ws_dma_ch[l], d->src, d->dst, d->ctrl, (const DMA_TransferDescriptor_t *)(uintptr_t)d->lli,
+                     s_ws_lane[l].dma_req, true);
+    }
+}
+
+#else
+
+/* The stream is already encoded: the flush only starts the channels */
+void ws_hw_write(const uint32_t *const *lanes, uint16_t n){
+    (void)lanes;
+    if (n > WS_LED_COUNT) n = WS_LED_COUNT;
+    if (!n) return;
+    for (uint8_t l = 0; l < WS_STRIPS; ++l)
+        ws_dma_start(s_ws_dma_ch[l], (uint32_t)(uintptr_t)s_ws_tx[l], (uint32_t)(uintptr_t)&s_ws_lane[l].ssp->DR,
+                     WS_SSP_DMA_CTRL((uint32_t)n * 9u), &s_ws_tail[l], s_ws_lane[l].dma_req, false);
+}
+
+#endif /* WS_DMA_STREAM */
+
+#endif /* WS_BACKEND_SSP_DMA */
@@ -0,0 +1,269 @@
+/*
+ * ws_hw_tmr.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ *
+ *  WS_BACKEND_TIMER_DMA: WS2812 waveforms on P3.25/P3.26 written by GPDMA,
+ *  paced by TIMER2/TIMER3 match events. No rewiring, no CPU in the loop.
+ *   - Both timers count half a WS bit and reset (MR3). MR0/MR1 toggle their
+ *     EM bit each half; the 0->1 edge raises the MATx.y DMA request, so each
+ *     line requests once per bit. EM starts at 0 and every event sits in the
+ *     first half, i.e. the T1H edge must come before the half-bit mark.
+ *   - Per bit, three channels write the port-3 SET/CLR registers:
+ *       MAT2.0 (TC 1):        SET all lanes           (constant word)
+ *       MAT2.1 (+T0H):        CLR lanes sending '0'   (one FIOCLR3 byte per bit)
+ *       MAT3.0 (+T1H):        CLR all lanes           (constant word)
+ *   - The per-bit CLR bytes are kept current by ws_hw_set_px(): one table
+ *     lookup per color byte gives its eight bytes as two words, merged into
+ *     the lane's pin with LDREX/STREX (both lanes share the bytes)
+ *   - WS_DMA_STREAM: the CLR bytes are encoded WS_DMA_CHUNK_LEDS at a time
+ *     from the palette front buffers into two ping-pong buffers, refilled on
+ *     each chunk's terminal count. The constant SET / CLR-all channels chain
+ *     4095-transfer descriptors for frames longer than one transfer.
+ *   - The CLR-all channel runs WS_TMR_LATCH_BITS more bits: the reset latch.
+ *     ws_hw_busy() stops the timers once it has finished.
+ *   - MAT lines are routed to the DMA (DMAREQSEL) only while a frame runs.
+ *     The match flags (which hold the DMA request: the latch keeps raising
+ *     them after the last channel ends) are cleared before the lines are
+ *     routed back, so no request from a stopped frame fires the next early.
+ *   - Timing comes from PCLK (div 1), not from the core or the optimizer;
+ *     TIMER3 starts a few PCLKs after TIMER2, which only lengthens T1H.
+ */
+
+#include "ws_hw.h"
+
+#if WS_BACKEND == WS_BACKEND_TIMER_DMA
+
+#include "chip.h"
+#include "bitband.h"
+#include "ws_pal.h"
+#include <string.h>
+
+#define WS_TMR_BIT_NS        1400u   /* 2 × half; T0L 1.0 µs, T1L 0.72 µs */
+#define WS_TMR_T0H_NS        400u
+#define WS_TMR_T1H_NS        680u    /* must end before the half-bit mark */
+#ifndef WS_TMR_LATCH_BITS
+#define WS_TMR_LATCH_BITS    48      /* 48 × 1.4 µs = 67 µs low (> 50 µs reset) */
+#endif
+#define WS_TMR_XFER_MAX      4095u   /* GPDMA transfer size field */
+#if WS_DMA_STREAM
+#define WS_TMR_BITS          (WS_DMA_CHUNK_LEDS * 24)   /* per ping-pong buffer */
+#else
+#define WS_TMR_BITS          (WS_LED_COUNT * 24)
+#endif
+/* Descriptors behind the first block of a constant channel (frame + latch) */
+#define WS_TMR_LLI           ((WS_LED_COUNT * 24u + WS_TMR_LATCH_BITS - 1u) / WS_TMR_XFER_MAX + 1u)
+
+#if WS_TMR_BITS + WS_TMR_LATCH_BITS > 4095
+#error "WS_LED_COUNT too large for one GPDMA transfer (4095 bits): set WS_DMA_STREAM"
+#endif
+
+/* DMA request lines 12..14 carry MAT2.0 / MAT2.1 / MAT3.0 when their DMAREQSEL bit is set */
+enum { WS_REQ_SET = 12, WS_REQ_CLR0 = 13, WS_REQ_CLR = 14 };
+#define WS_REQSEL_BITS  ((1u << (WS_REQ_SET - 8)) | (1u << (WS_REQ_CLR0 - 8)) | (1u << (WS_REQ_CLR - 8)))
+
+static const uint32_t s_ws_pins[WS_STRIPS] = {
+    LED_PIN_STRIP1,
+#if WS_STRIPS > 1
+    LED_PIN_STRIP2,
+#endif
+};
+
+/* Color byte -> eight 0/1 bytes (1 = bit is '0', MSB first in memory), built at compile time */
+#define WS_Z(v, b)   ((((v) >> (b)) & 1u) ? 0u : 1u)
+#define WS_ZW(v, b)  (WS_Z(v, b) | (WS_Z(v, (b) - 1) << 8) | (WS_Z(v, (b) - 2) << 16) | (WS_Z(v, (b) - 3) << 24))
+#define WS_ZB(v)     { WS_ZW((v), 7), WS_ZW((v), 3) }
+#define WS_ZB4(v)    WS_ZB(v), WS_ZB((v) + 1), WS_ZB((v) + 2), WS_ZB((v) + 3)
+#define WS_ZB16(v)   WS_ZB4(v), WS_ZB4((v) + 4), WS_ZB4((v) + 8), WS_ZB4((v) + 12)
+#define WS_ZB64(v)   WS_ZB16(v), WS_ZB16((v) + 16), WS_ZB16((v) + 32), WS_ZB16((v) + 48)
+static const uint32_t s_ws_zero[256][2] = { WS_ZB64(0), WS_ZB64(64), WS_ZB64(128), WS_ZB64(192) };
+
+WS_DMA_RAM static uint32_t s_ws_all;                 /* SET / CLR word of every lane */
+WS_DMA_RAM static DMA_TransferDescriptor_t s_ws_lli_set[WS_TMR_LLI], s_ws_lli_clr[WS_TMR_LLI];
+static uint8_t s_ws_ch_set, s_ws_ch_clr0, s_ws_ch_clr;
+static uint8_t s_ws_running;
+#if WS_DMA_STREAM
+/* per bit: FIOCLR3 byte of the lanes sending '0' */
+WS_DMA_RAM static uint32_t s_ws_clr0[2][WS_TMR_BITS / 4];
+WS_DMA_RAM static DMA_TransferDescriptor_t s_ws_lli_clr0[2];   /* one per buffer */
+static const uint32_t *const *s_ws_src;   /* front buffers being sent */
+static uint16_t s_ws_n, s_ws_next;        /* LEDs in the frame, next chunk to encode */
+#else
+WS_DMA_RAM static uint32_t s_ws_clr0[WS_TMR_BITS / 4];
+#endif
+
+#define WS_DMA_WORD  (GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_WORD) | GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_WORD))
+#define WS_DMA_BYTE  (GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_BYTE) | GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_BYTE))
+
+static void ws_tmr_setup(LPC_TIMER_T *t, uint32_t half){
+    Chip_TIMER_Init(t);
+    Chip_TIMER_Disable(t);
+    Chip_TIMER_PrescaleSet(t, 0);
+    Chip_TIMER_SetMatch(t, 3, half - 1u);
+    Chip_TIMER_ResetOnMatchEnable(t, 3);
+}
+
+/* Event `d` ticks after the bit starts (TC 1) */
+static void ws_tmr_event(LPC_TIMER_T *t, int8_t mr, uint32_t d){
+    Chip_TIMER_SetMatch(t, mr, 1u + d);
+}
+
+static void ws_tmr_stop(void){
+    Chip_TIMER_Disable(LPC_TIMER2);
+    Chip_TIMER_Disable(LPC_TIMER3);
+    LPC_SYSCTL->DMAREQSEL &= ~WS_REQSEL_BITS;   /* lines back to UART0..3 (no DMA there) */
+    s_ws_running = 0;
+}
+
+/* `count` copies of s_ws_all: the first block by register, the rest chained in `lli` */
+static void ws_tmr_const(uint8_t ch, uint32_t dst, uint32_t count, DMA_TransferDescriptor_t *lli, uint8_t req){
+    const uint32_t src = (uint32_t)(uintptr_t)&s_ws_all;
+    const uint32_t first = (count > WS_TMR_XFER_MAX) ? WS_TMR_XFER_MAX : count;
+    count -= first;
+    const DMA_TransferDescriptor_t *next = count ? lli : NULL;
+    for (DMA_TransferDescriptor_t *d = lli; count; ++d){
+        const uint32_t c = (count > WS_TMR_XFER_MAX) ? WS_TMR_XFER_MAX : count;
+        count -= c;
+        *d = (DMA_TransferDescriptor_t){ src, dst, count ? (uint32_t)(uintptr_t)(d + 1) : 0u,
+                                         GPDMA_DMACCxControl_TransferSize(c) | WS_DMA_WORD };
+    }
+    ws_dma_start(ch, src, dst, GPDMA_DMACCxControl_TransferSize(first) | WS_DMA_WORD, next, req, false);
+}
+
+#if WS_DMA_STREAM
+
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c){ (void)lane; (void)idx; (void)c; }   /* encoded per chunk */
+
+/* Encode chunk j (every lane) into its buffer and link it to the next chunk */
+static void ws_chunk_fill(uint16_t j){
+    const uint16_t first = (uint16_t)(j * WS_DMA_CHUNK_LEDS), len = ws_chunk_len(j, s_ws_n);
+    uint32_t * const buf = s_ws_clr0[j & 1u];
+    for (uint16_t i = 0; i < len; ++i){
+        uint32_t * const w = &buf[i * 6u];
+        w[0] = w[1] = w[2] = w[3] = w[4] = w[5] = 0;
+        for (uint8_t l = 0; l < WS_STRIPS; ++l){
+            const RGB_t c = g_ws_pal[ws_pal_get(s_ws_src[l], (uint16_t)(first + i))];
+            const uint32_t pin = s_ws_pins[l] >> 24;
+            w[0] |= s_ws_zero[c.g][0] * pin; w[1] |= s_ws_zero[c.g][1] * pin;
+            w[2] |= s_ws_zero[c.r][0] * pin; w[3] |= s_ws_zero[c.r][1] * pin;
+            w[4] |= s_ws_zero[c.b][0] * pin; w[5] |= s_ws_zero[c.b][1] * pin;
+        }
+    }
+    const bool last = (uint16_t)(j + 1u) >= ws_chunks(s_ws_n);
+    s_ws_lli_clr0[j & 1u] = (DMA_TransferDescriptor_t){
+        (uint32_t)(uintptr_t)buf, (uint32_t)(uintptr_t)&LPC_GPIO[3].CLR + 3u,
+        last ? 0u : (uint32_t)(uintptr_t)&s_ws_lli_clr0[(j + 1u) & 1u],
+        GPDMA_DMACCxControl_TransferSize((uint32_t)len * 24u) | WS_DMA_BYTE | GPDMA_DMACCxControl_SI
+        | GPDMA_DMACCxControl_I };
+}
+
+/* Chunk k done: its buffer takes chunk k + 2 while k + 1 is on the wire */
+void DMA_IRQHandler(void){
+    const uint32_t bit = 1u << s_ws_ch_clr0;
+    if (!(LPC_GPDMA->INTTCSTAT & bit)) return;
+    LPC_GPDMA->INTTCCLEAR = bit;
+    if (s_ws_next < ws_chunks(s_ws_n)) ws_chunk_fill(s_ws_next++);
+}
+
+#else
+
+static inline void ws_enc_byte(volatile uint32_t *w, uint32_t pin, uint8_t v){
+    mask_assign(&w[0], 0x01010101u * pin, s_ws_zero[v][0] * pin);
+    mask_assign(&w[1], 0x01010101u * pin, s_ws_zero[v][1] * pin);
+}
+
+void ws_hw_set_px(uint8_t lane, uint16_t idx, RGB_t c){
+    if (lane >= WS_STRIPS || idx >= WS_LED_COUNT) return;
+    const uint32_t pin = s_ws_pins[lane] >> 24;
+    volatile uint32_t *w = &s_ws_clr0[idx * 6u];
+    ws_enc_byte(&w[0], pin, c.g);
+    ws_enc_byte(&w[2], pin, c.r);
+    ws_enc_byte(&w[4], pin, c.b);
+}
+
+#endif /* WS_DMA_STREAM */
+
+void ws_hw_init(void){
+    Chip_Clock_SetPCLKDiv(SYSCTL_PCLK_TIMER3, SYSCTL_CLKDIV_1);   /* same count rate as TIMER2 */
+    const uint32_t pclk = Chip_Clock_GetPeripheralClockRate(SYSCTL_PCLK_TIMER2);
+    const uint32_t tpus = pclk / 1000000u;                       /* ticks per µs */
+    const uint32_t half = (tpus * WS_TMR_BIT_NS) / 2000u;
+    uint32_t t1h = (tpus * WS_TMR_T1H_NS) / 1000u;
+    if (t1h > half - 2u) t1h = half - 2u;
+
+    ws_tmr_setup(LPC_TIMER2, half);
+    ws_tmr_setup(LPC_TIMER3, half);
+    ws_tmr_event(LPC_TIMER2, 0, 0);
+    ws_tmr_event(LPC_TIMER2, 1, (tpus * WS_TMR_T0H_NS) / 1000u);
+    ws_tmr_event(LPC_TIMER3, 0, t1h);
+
+    s_ws_all = 0;
+    for (uint8_t l = 0; l < WS_STRIPS; ++l) s_ws_all |= s_ws_pins[l];
+#if !WS_DMA_STREAM
+    memset(s_ws_clr0, (int)(s_ws_all >> 24), sizeof(s_ws_clr0));   /* every lane dark */
+#endif
+
+    Chip_GPDMA_Init(LPC_GPDMA);
+    s_ws_ch_set  = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, GPDMA_CONN_MAT2_0);
+    s_ws_ch_clr0 = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, GPDMA_CONN_MAT2_1);
+    s_ws_ch_clr  = Chip_GPDMA_GetFreeChannel(LPC_GPDMA, GPDMA_CONN_MAT3_0);
+#if WS_DMA_STREAM
+    NVIC_SetPriority(DMA_IRQn, IRQ_PRIO_WS_DMA);
+    NVIC_EnableIRQ(DMA_IRQn);
+#endif
+}
+
+bool ws_hw_busy(void){
+    if (!s_ws_running) return false;
+    if (Chip_GPDMA_IntGetStatus(LPC_GPDMA, GPDMA_STAT_ENABLED_CH, s_ws_ch_clr) == SET) return true;
+    ws_tmr_stop();   /* latch done */
+    return false;
+}
+
+/* Pre-encoded: the flush only starts timers and channels. WS_DMA_STREAM: the
+   first two chunks are encoded here, the DMA interrupt keeps one chunk ahead. */
+void ws_hw_write(const uint32_t *const *lanes, uint16_t n){
+    if (n > WS_LED_COUNT) n = WS_LED_COUNT;
+    if (!n) return;
+
+    const uint32_t bits = (uint32_t)n * 24u;
+#if WS_DMA_STREAM
+    s_ws_src = lanes; s_ws_n = n;
+    ws_chunk_fill(0);
+    if (ws_chunks(n) > 1) ws_chunk_fill(1);
+    s_ws_next = 2;
+#else
+    (void)lanes;
+#endif
+
+    /* Timers stopped and reset, EM bits low, pending match requests dropped;
+       MAT lines routed to the DMA only now */
+    Chip_TIMER_Disable(LPC_TIMER2); Chip_TIMER_Disable(LPC_TIMER3);
+    Chip_TIMER_Reset(LPC_TIMER2);   Chip_TIMER_Reset(LPC_TIMER3);
+    Chip_TIMER_ExtMatchControlSet(LPC_TIMER2, 0, TIMER_EXTMATCH_TOGGLE, 0);
+    Chip_TIMER_ExtMatchControlSet(LPC_TIMER2, 0, TIMER_EXTMATCH_TOGGLE, 1);
+    Chip_TIMER_ExtMatchControlSet(LPC_TIMER3, 0, TIMER_EXTMATCH_TOGGLE, 0);
+    Chip_TIMER_ClearMatch(LPC_TIMER2, 0);
+    Chip_TIMER_ClearMatch(LPC_TIMER2, 1);
+    Chip_TIMER_ClearMatch(LPC_TIMER3, 0);
+    LPC_SYSCTL->DMAREQSEL |= WS_REQSEL_BITS;
+
+    ws_tmr_const(s_ws_ch_set, (uint32_t)(uintptr_t)&LPC_GPIO[3].SET, bits, s_ws_lli_set, WS_REQ_SET);
+#if WS_DMA_STREAM
+    const DMA_TransferDescriptor_t *d = &s_ws_lli_clr0[0];
+    ws_dma_start(s_ws_ch_clr0, d->src, d->dst, d->ctrl, (const DMA_TransferDescriptor_t *)(uintptr_t)d->lli,
+                 WS_REQ_CLR0, true);
+#else
+    ws_dma_start(s_ws_ch_clr0, (uint32_t)(uintptr_t)s_ws_clr0, (uint32_t)(uintptr_t)&LPC_GPIO[3].CLR + 3u,
+                 GPDMA_DMACCxControl_TransferSize(bits) | WS_DMA_BYTE | GPDMA_DMACCxControl_SI, NULL,
+                 WS_REQ_CLR0, false);
+#endif
+    ws_tmr_const(s_ws_ch_clr, (uint32_t)(uintptr_t)&LPC_GPIO[3].CLR, bits + WS_TMR_LATCH_BITS, s_ws_lli_clr, WS_REQ_CLR);
+
+    s_ws_running = 1;
+    Chip_TIMER_Enable(LPC_TIMER2);
+    Chip_TIMER_Enable(LPC_TIMER3);
+}
+
+#endif /* WS_BACKEND_TIMER_DMA */
@@ -5,13 +5,17 @@
  *      Author: mad23
  *
  *  Flicker-safe WS2812 driver glue:
- *   - Atomic hardware writes (mask IRQs during tight WS timing)
+ *   - Palette-indexed framebuffer (ws_pal.h), WS_PAL_BITS per LED
+ *   - Back buffer for the ISR writers, front buffer for the encoder
+ *   - Hardware writes through ws_hw.h (WS_BACKEND: bit-bang or SSP + GPDMA)
  *   - Optional coalescing via WS_MIN_FLUSH_TICKS (tick = 70 ms in your system)
- *   - No CMSIS dependency; uses small inline-asm helpers for PRIMASK
  */
 
 #include "ws_led.h"
-#include "ws2812b.h"
+#include "ws_hw.h"
+#include "ws_pal.h"
+#include "app_wake.h"
+#include "bitband.h"
 #include <string.h>
 
 
@@ -25,67 +29,154 @@
 #define WS_MIN_FLUSH_TICKS 0
 #endif
 
-/* If you physically drive only one strip, set to 0 to halve blocked time. */
-#ifndef WS_HAS_STRIP2
-#define WS_HAS_STRIP2 1
-#endif
+extern volatile uint32_t g_tick;
 
 
-extern volatile uint32_t g_tick;
+/* Palette with brightness and a ~2.2 gamma (0.8·x² + 0.2·x³), all constant expressions */
+#define WS_DIM(v)    ((uint32_t)(v) * WS_BRIGHTNESS / 255u)
+#define WS_GAMMA(v)  ((4u * (v) * (v) * 255u + (v) * (v) * (v)) / (5u * 255u * 255u))
+#define WS_LVL(v)    ((uint8_t)WS_GAMMA(WS_DIM(v)))
+#define WS_RGB(r, g, b)  { WS_LVL(r), WS_LVL(g), WS_LVL(b) }
+
+const RGB_t g_ws_pal[WS_PAL_SIZE] = {
+    [WS_PAL_OFF]       = WS_RGB(0, 0, 0),
+    [WS_PAL_RED]       = WS_RGB(255, 0, 0),
+    [WS_PAL_GREEN]     = WS_RGB(0, 255, 0),
+    [WS_PAL_BLUE]      = WS_RGB(0, 0, 255),
+#if WS_PAL_BITS == 4
+    [WS_PAL_YELLOW]    = WS_RGB(255, 255, 0),
+    [WS_PAL_CYAN]      = WS_RGB(0, 255, 255),
+    [WS_PAL_MAGENTA]   = WS_RGB(255, 0, 255),
+    [WS_PAL_WHITE]     = WS_RGB(255, 255, 255),
+    [WS_PAL_ORANGE]    = WS_RGB(255, 128, 0),
+    [WS_PAL_PURPLE]    = WS_RGB(128, 0, 255),
+    [WS_PAL_DIM_RED]   = WS_RGB(64, 0, 0),
+    [WS_PAL_DIM_GREEN] = WS_RGB(0, 64, 0),
+    [WS_PAL_DIM_BLUE]  = WS_RGB(0, 0, 64),
+    [WS_PAL_DIM_WHITE] = WS_RGB(64, 64, 64),
+    [WS_PAL_AMBER]     = WS_RGB(255, 191, 0),
+    [WS_PAL_PINK]      = WS_RGB(255, 105, 180),
+#endif
+};
 
+#define WS_WORDS         WS_PAL_WORDS(WS_LED_COUNT)
+#define WS_PUBLISH_TRIES 4   /* snapshot attempts per flush before leaving it to the next pass */
 
-static RGB_t   ws_buf[WS_LED_COUNT];
-static WS2812B ws_b1 = { .leds = ws_buf, .num_leds = WS_LED_COUNT };
-#if WS_HAS_STRIP2
-static WS2812B ws_b2 = { .leds = ws_buf, .num_leds = WS_LED_COUNT };
+static volatile uint32_t ws_buf[WS_STRIPS][WS_WORDS];   /* back: written by ISRs, never sent */
+static uint32_t          ws_front[WS_STRIPS][WS_WORDS]; /* front: what the strips show (flush only) */
+static const uint32_t * const ws_lane[WS_STRIPS] = {
+    ws_front[0],
+#if WS_STRIPS > 1
+    ws_front[1],
 #endif
+};
+static volatile uint32_t s_ws_gen;                     /* bumped by every back-buffer write */
+
+/* Segments: a run of LEDs on one strip mirroring one BIN (BIN LED n = strip LED first + n - 1) */
+typedef struct { uint8_t strip, bin; uint16_t first, count; } WsSeg;
+#define WS_SEGMENT(strip, bin, first, count)  { strip, bin, first, count },
+static const WsSeg s_ws_seg[] = { WS_SEGMENTS };
+#undef WS_SEGMENT
+/* Each segment must fit its strip: refused here rather than skipped at run time */
+#define WS_SEGMENT(strip, bin, first, count) \
+    _Static_assert((strip) < WS_STRIPS && (uint32_t)(first) + (count) <= WS_LED_COUNT, \
+                   "WS_SEGMENTS: segment outside its strip (strip >= WS_STRIPS or past WS_LED_COUNT)");
+WS_SEGMENTS
+#undef WS_SEGMENT
+#define WS_SEGS  (sizeof(s_ws_seg) / sizeof(s_ws_seg[0]))
 
 
 static volatile uint8_t  s_ws_flush_pending = 0;   /* request from callers */
-static volatile uint8_t  s_ws_dirty         = 0;   /* buffer changed since last flush */
-static volatile uint16_t s_ws_last_led_bin1 = 0;   /* for ws_set_only_bin1() */
+static volatile uint32_t s_ws_dirty_len     = 0;   /* LEDs to send: highest changed index + 1 (0 = clean) */
+static volatile uint16_t s_ws_lit_len[WS_STRIPS];  /* per strip: no LED lit at or beyond this index */
+static volatile uint16_t s_ws_last_led[WS_SEGS];   /* per segment, for ws_set_only_bin() */
 
 #if WS_MIN_FLUSH_TICKS > 0
 static uint16_t s_ws_next_flush_tick = 0;          /* coalescing window */
 #endif
 
 
-static inline uint32_t primask_save_and_disable(void){
-    uint32_t primask;
-    __asm volatile ("MRS %0, PRIMASK" : "=r"(primask) ::);
-    __asm volatile ("cpsid i" ::: "memory");
-    return primask;
+/* Writers at different ISR priorities may race: raise the length with LDREX/STREX */
+static inline void ws_mark_dirty_and_request_flush(uint16_t len){
+    uint32_t o;
+    do { o = __LDREXW(&s_ws_dirty_len); } while (__STREXW(o > len ? o : len, &s_ws_dirty_len));
+    s_ws_flush_pending = 1;
+}
+
+static inline void ws_lit_raise(uint8_t strip, uint16_t len){
+    uint16_t o;
+    do { o = __LDREXH(&s_ws_lit_len[strip]); } while (__STREXH(o > len ? o : len, &s_ws_lit_len[strip]));
+}
+
+/* Everything lit on the strip goes dark: send up to the last LED that may be on */
+static inline void ws_dirty_lit(uint8_t strip){
+    if (s_ws_lit_len[strip]) ws_mark_dirty_and_request_flush(s_ws_lit_len[strip]);
+    s_ws_lit_len[strip] = 0;
+}
+
+/* Every pixel write goes through here; the flush sees s_ws_gen move and re-takes its snapshot */
+static inline void ws_px_put(uint8_t strip, uint16_t idx, uint8_t c){
+    uint32_t o;
+    ws_pal_put(ws_buf[strip], idx, c);
+    do { o = __LDREXW(&s_ws_gen); } while (__STREXW(o + 1u, &s_ws_gen));
 }
-static inline void primask_restore(uint32_t primask){
-    if ((primask & 1u) == 0u){
-        __asm volatile ("cpsie i" ::: "memory");
+
+/* Copy the back buffer into the front; DMA backends re-encode only the LEDs that changed */
+static void ws_publish(void){
+    for (uint8_t s = 0; s < WS_STRIPS; ++s){
+        for (uint16_t w = 0; w < WS_WORDS; ++w){
+            uint32_t v = ws_buf[s][w], d = v ^ ws_front[s][w];
+            if (!d) continue;
+            ws_front[s][w] = v;
+            for (uint16_t i = (uint16_t)(w * WS_PAL_PER_WORD); d; ++i, d >>= WS_PAL_BITS, v >>= WS_PAL_BITS)
+                if ((d & (WS_PAL_SIZE - 1u)) && i < WS_LED_COUNT)
+                    ws_hw_set_px(s, i, g_ws_pal[v & (WS_PAL_SIZE - 1u)]);
+        }
     }
 }
 
-/* Prevent any ISR from jittering the WS2812 bitstream.
-   ~3 ms per 96 LEDs per strip @800 kHz. */
-static inline void ws_write_atomic(void){
-    uint32_t ps = primask_save_and_disable();
+static inline bool ws_px_off(uint8_t strip, uint16_t idx){
+    if (ws_pal_get(ws_buf[strip], idx) == WS_PAL_OFF) return false;
+    ws_px_put(strip, idx, WS_PAL_OFF);
+    return true;
+}
 
-    WS2812B_write(&ws_b1);
-#if WS_HAS_STRIP2
-    WS2812B_write(&ws_b2);
-#endif
+/* Set one LED if it differs; keeps lit/dirty tracking */
+static inline void ws_px_set(uint8_t strip, uint16_t idx, uint8_t c){
+    if (ws_pal_get(ws_buf[strip], idx) == c) return;
+    ws_px_put(strip, idx, c);
+    if (c != WS_PAL_OFF) ws_lit_raise(strip, (uint16_t)(idx + 1u));
+    ws_mark_dirty_and_request_flush((uint16_t)(idx + 1u));
+}
 
-    primask_restore(ps);
+/* Segment mirrors `bin` (all segments fit their strip, see WS_SEGMENT above) */
+static inline bool ws_seg_is(const WsSeg *g, uint8_t bin){
+    return g->bin == bin;
 }
 
-static inline void ws_mark_dirty_and_request_flush(void){
-    s_ws_dirty = 1;
-    s_ws_flush_pending = 1;
+/* Turn off the segment's LEDs, up to what its strip may have lit */
+static void ws_seg_dark(const WsSeg *g){
+    const uint16_t end = (uint16_t)(g->first + g->count), lit = s_ws_lit_len[g->strip];
+    uint16_t hi = 0;
+    for (uint16_t i = g->first; i < end && i < lit; ++i) if (ws_px_off(g->strip, i)) hi = (uint16_t)(i + 1u);
+    if (hi) ws_mark_dirty_and_request_flush(hi);
+}
+
+/* Turn off every LED the strip may have lit */
+static void ws_strip_dark(uint8_t strip){
+    for (uint16_t i = 0; i < s_ws_lit_len[strip]; ++i) (void)ws_px_off(strip, i);
+    ws_dirty_lit(strip);
 }
 
 /* ===== Public API (matches ws_led.h) ==================================== */
 
 void ws_init(void){
-    memset(ws_buf, 0, sizeof(ws_buf));
-    s_ws_last_led_bin1 = 0;
-    s_ws_dirty = 1;
+    ws_hw_init();
+    memset((void *)ws_buf, 0, sizeof(ws_buf));
+    memset(ws_front, 0, sizeof(ws_front));   /* matches the zero stream from ws_hw_init() */
+    memset((void *)s_ws_last_led, 0, sizeof(s_ws_last_led));
+    memset((void *)s_ws_lit_len, 0, sizeof(s_ws_lit_len));
+    s_ws_dirty_len = WS_LED_COUNT;   /* strip state unknown: one full frame */
     s_ws_flush_pending = 1;
 #if WS_MIN_FLUSH_TICKS > 0
     s_ws_next_flush_tick = (uint16_t)g_tick;  /* allow immediate first flush */
@@ -94,11 +185,12 @@ void ws_init(void){
 
 void ws_request_flush(void){
     s_ws_flush_pending = 1;
+    if (s_ws_dirty_len) app_wake_from_isr(WAKE_WS);
 }
 
 void ws_flush_if_pending(void){
     if (!s_ws_flush_pending) return;   /* nothing requested */
-    if (!s_ws_dirty){                  /* no visual change */
+    if (!s_ws_dirty_len){              /* no visual change */
         s_ws_flush_pending = 0;
         return;
     }
@@ -111,12 +203,27 @@ void ws_flush_if_pending(void){
     }
 #endif
 
-    /* Do the actual hardware write atomically */
-    ws_write_atomic();
+    /* DMA backend: previous frame still on the wire; retried on the next pass */
+    if (ws_hw_busy()) return;
 
-    /* Bookkeeping */
-    s_ws_dirty = 0;
+    /* Publish back -> front. Writers are ISRs and never wait: if one ran during
+       the copy (s_ws_gen moved), copy again, so a frame never holds half of a
+       writer's update. A write after the snapshot marks dirty for the next flush.
+       LEDs past the prefix keep their color (no data reaches them). */
     s_ws_flush_pending = 0;
+    uint16_t n = 0;
+    for (uint8_t t = 0; ; ++t){
+        const uint32_t gen = s_ws_gen;
+        const uint16_t len = (uint16_t)mask_take(&s_ws_dirty_len, 0xFFFFFFFFu);
+        if (len > n) n = len;
+        ws_publish();
+        if (s_ws_gen == gen) break;
+        if (t + 1u >= WS_PUBLISH_TRIES){   /* writers too busy: keep it pending */
+            ws_mark_dirty_and_request_flush(n);
+            return;
+        }
+    }
+    ws_hw_write(ws_lane, n);
 
 #if WS_MIN_FLUSH_TICKS > 0
     s_ws_next_flush_tick = (uint16_t)((uint16_t)g_tick + WS_MIN_FLUSH_TICKS);
@@ -124,45 +231,154 @@ void ws_flush_if_pending(void){
 }
 
 void ws_clear_all(void){
-    memset(ws_buf, 0, sizeof(ws_buf));
-    s_ws_last_led_bin1 = 0;
-    ws_mark_dirty_and_request_flush();
+    ws_fx_stop_all();
+    memset((void *)s_ws_last_led, 0, sizeof(s_ws_last_led));
+    for (uint8_t s = 0; s < WS_STRIPS; ++s) ws_strip_dark(s);
 }
 
-void ws_set_red_1indexed(uint16_t led1){
-    if (!led1 || led1 > WS_LED_COUNT) return;
-    const uint16_t idx = (uint16_t)(led1 - 1);
-    const RGB_t old = ws_buf[idx];
-
-    /* Skip if no visible change */
-    if (old.r == 255 && old.g == 0 && old.b == 0) return;
+void ws_set_red_1indexed(uint8_t strip, uint16_t led1){
+    if (strip >= WS_STRIPS || !led1 || led1 > WS_LED_COUNT) return;
+    ws_px_set(strip, (uint16_t)(led1 - 1), WS_PAL_RED);   /* no-op if already red */
+}
 
-    ws_buf[idx].r = 255; ws_buf[idx].g = 0; ws_buf[idx].b = 0;
-    ws_mark_dirty_and_request_flush();
+void ws_set_only_bin(uint8_t bin, uint16_t led1){
+    for (uint8_t k = 0; k < WS_SEGS; ++k){
+        const WsSeg * const g = &s_ws_seg[k];
+        if (!ws_seg_is(g, bin)) continue;
+        /* Turn off the segment's previous LED if any */
+        const uint16_t prev = s_ws_last_led[k];
+        if (prev && prev <= g->count && prev != led1 && ws_px_off(g->strip, (uint16_t)(g->first + prev - 1)))
+            ws_mark_dirty_and_request_flush((uint16_t)(g->first + prev));
+        s_ws_last_led[k] = led1;
+        if (led1 && led1 <= g->count)   /* marks dirty & requests flush */
+            ws_px_set(g->strip, (uint16_t)(g->first + led1 - 1), WS_PAL_RED);
+    }
 }
 
-void ws_set_only_bin1(uint16_t led1){
-    /* Turn off previous BIN1 LED if any */
-    if (s_ws_last_led_bin1 && s_ws_last_led_bin1 <= WS_LED_COUNT){
-        const uint16_t prev = (uint16_t)(s_ws_last_led_bin1 - 1);
-        if (ws_buf[prev].r | ws_buf[prev].g | ws_buf[prev].b){
-            ws_buf[prev].r = ws_buf[prev].g = ws_buf[prev].b = 0;
+void ws_set_mask_bin1_and_clear_others(uint8_t max_led, const uint8_t *list){
+    for (uint8_t k = 0; k < WS_SEGS; ++k){
+        const WsSeg * const g = &s_ws_seg[k];
+        if (!ws_seg_is(g, 1)) continue;
+        s_ws_last_led[k] = 0;
+        ws_seg_dark(g);   /* old lit LEDs go dark */
+
+        uint16_t hi = 0;
+        for (uint8_t i = 0; i < max_led; ++i){
+            const uint8_t l = list[i];
+            if (l >= 1 && l <= g->count){
+                ws_px_put(g->strip, (uint16_t)(g->first + l - 1), WS_PAL_RED);
+                if (g->first + l > hi) hi = (uint16_t)(g->first + l);
+            }
         }
+        ws_lit_raise(g->strip, hi);
+        if (hi) ws_mark_dirty_and_request_flush(hi);
     }
-    s_ws_last_led_bin1 = led1;
-    ws_set_red_1indexed(led1);  /* marks dirty & requests flush */
 }
 
-void ws_set_mask_bin1_and_clear_others(uint8_t max_led, const uint8_t *list){
-    memset(ws_buf, 0, sizeof(ws_buf));
-    s_ws_last_led_bin1 = 0;
-
-    for (uint8_t i = 0; i < max_led; ++i){
-        const uint8_t l = list[i];
-        if (l >= 1 && l <= WS_LED_COUNT){
-            const uint16_t idx = (uint16_t)(l - 1);
-            ws_buf[idx].r = 255; ws_buf[idx].g = 0; ws_buf[idx].b = 0;
+/* ===== Effects ========================================================== */
+
+typedef struct {
+    volatile uint8_t kind;   /* WS_FX_*, published last by ws_fx_set() */
+    uint8_t  bin;            /* runs on every segment mirroring this BIN */
+    uint8_t  colour;         /* palette index */
+    uint8_t  arg;            /* blink: duty %; chase: pattern */
+    uint16_t first, count;   /* LED range in the segment, 0-based */
+    uint16_t period_ms;      /* blink / pulse cycle, chase step */
+    uint16_t t_ms;           /* position in the period */
+    uint8_t  step;           /* chase shift, 0..7 */
+    uint8_t  pcol;           /* pulse: colour of this tick */
+    uint16_t acc;            /* pulse: dither accumulator (of 256) */
+} WsFx;
+
+static WsFx s_ws_fx[WS_FX_MAX];
+
+static uint8_t ws_fx_colour(const WsFx *f, uint16_t i){
+    switch (f->kind){
+        case WS_FX_BLINK:
+            return ((uint32_t)f->t_ms * 100u < (uint32_t)f->period_ms * f->arg) ? f->colour : WS_PAL_OFF;
+        case WS_FX_PULSE:
+            return f->pcol;
+        case WS_FX_CHASE:
+            return ((f->arg >> ((uint16_t)(i - f->step) & 7u)) & 1u) ? f->colour : WS_PAL_OFF;
+        default:
+            return WS_PAL_OFF;
+    }
+}
+
+/* Pulse: a triangle level (0..256) over the period, shown by temporal dithering,
+   one decision per WS tick: OFF/colour, or OFF/dim and dim/colour when the
+   palette has a dim entry of that hue (taken as half level). */
+static void ws_fx_pulse_step(WsFx *f){
+    const uint32_t t = f->t_ms, p = f->period_ms;
+    const uint32_t level = (2u * t < p) ? (512u * t) / p : (512u * (p - t)) / p;
+    const uint8_t dim = ws_pal_dim(f->colour);
+    uint8_t lo = WS_PAL_OFF, hi = f->colour;
+    uint32_t frac = level;
+    if (dim != f->colour){
+        if (level < 128u){ hi = dim; frac = level * 2u; }
+        else             { lo = dim; frac = (level - 128u) * 2u; }
+    }
+    f->acc = (uint16_t)(f->acc + frac);
+    if (f->acc >= 256u){ f->acc = (uint16_t)(f->acc - 256u); f->pcol = hi; }
+    else f->pcol = lo;
+}
+
+static void ws_fx_render(const WsFx *f, bool off){
+    for (uint8_t k = 0; k < WS_SEGS; ++k){
+        const WsSeg * const g = &s_ws_seg[k];
+        if (!ws_seg_is(g, f->bin)) continue;
+        for (uint16_t i = 0; i < f->count && f->first + i < g->count; ++i)
+            ws_px_set(g->strip, (uint16_t)(g->first + f->first + i), off ? WS_PAL_OFF : ws_fx_colour(f, i));
+    }
+}
+
+/* The tick (higher priority) skips the slot from here on; its LEDs go dark */
+static void ws_fx_off(WsFx *f){
+    if (f->kind == WS_FX_NONE) return;
+    f->kind = WS_FX_NONE;
+    ws_fx_render(f, true);
+}
+
+bool ws_fx_set(uint8_t slot, uint8_t kind, uint8_t bin, uint16_t led1, uint16_t count,
+               uint8_t colour, uint16_t period_ms, uint8_t arg){
+    if (slot >= WS_FX_MAX || kind > WS_FX_CHASE) return false;
+    WsFx * const f = &s_ws_fx[slot];
+    ws_fx_off(f);
+    if (kind == WS_FX_NONE) return true;
+    if (!led1 || led1 > WS_LED_COUNT || !count || !period_ms || colour >= WS_PAL_SIZE) return false;
+
+    bool any = false;
+    for (uint8_t k = 0; k < WS_SEGS; ++k) any |= ws_seg_is(&s_ws_seg[k], bin) && led1 <= s_ws_seg[k].count;
+    if (!any) return false;
+
+    f->bin = bin; f->colour = colour; f->arg = arg;   /* render clips the range to each segment */
+    f->first = (uint16_t)(led1 - 1); f->count = count;
+    f->period_ms = period_ms; f->t_ms = 0; f->step = 0;
+    f->pcol = WS_PAL_OFF; f->acc = 0;
+    __DMB();
+    f->kind = kind;   /* publish last: the tick sees all or nothing */
+    return true;
+}
+
+void ws_fx_stop_all(void){
+    for (uint8_t k = 0; k < WS_FX_MAX; ++k) ws_fx_off(&s_ws_fx[k]);
+}
+
+void ws_fx_tick(uint16_t ms){
+    for (uint8_t k = 0; k < WS_FX_MAX; ++k){
+        WsFx * const f = &s_ws_fx[k];
+        if (f->kind == WS_FX_NONE) continue;
+        f->t_ms = (uint16_t)(f->t_ms + ms);
+        if (f->t_ms >= f->period_ms){
+            f->t_ms = (uint16_t)(f->t_ms % f->period_ms);
+            f->step = (uint8_t)((f->step + 1u) & 7u);
         }
+        if (f->kind == WS_FX_PULSE) ws_fx_pulse_step(f);
+        ws_fx_render(f, false);
     }
-    ws_mark_dirty_and_request_flush();
+}
+
+bool ws_fx_active(void){
+    for (uint8_t k = 0; k < WS_FX_MAX; ++k) if (s_ws_fx[k].kind != WS_FX_NONE) return true;
+    return false;
 }
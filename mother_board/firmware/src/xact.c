@@ -0,0 +1,126 @@
+/*
+ * xact.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: mad23
+ */
+
+#include "xact.h"
+#include "queues.h"
+#include "sched.h"
+#include <string.h>
+
+enum { XS_FREE = 0, XS_QUEUED, XS_RUNNING };
+
+static Xact    s_xact[XACT_MAX];
+static uint8_t s_owner[XACT_BUSES] = { [0 ... XACT_BUSES - 1] = 0xFF };   // running slot per bus
+static uint8_t s_gen;
+
+static void xact_free(uint8_t i){
+    Xact *x = &s_xact[i];
+    x->want_sc = 0;          // RX no longer matches
+    x->state = XS_FREE;
+}
+
+uint8_t xact_start(uint8_t seg, xact_fn body, xact_done_fn done, void *ctx){
+    if (seg >= XACT_BUSES || !body) return 0xFF;
+    for (uint8_t i = 0; i < XACT_MAX; ++i){
+        Xact *x = &s_xact[i];
+        if (x->state != XS_FREE) continue;
+        x->lc = 0; x->seg = seg; x->body = body; x->done = done; x->ctx = ctx;
+        x->want_sc = 0; x->rx_len = 0; x->tries = 0;
+        x->gen = (uint8_t)(++s_gen & 0x7F);
+        x->rx_gen = (uint8_t)~x->gen;
+        x->state = XS_QUEUED;
+        return i;
+    }
+    return 0xFF;
+}
+
+static uint8_t xact_request_body(Xact *x){
+    XACT_BEGIN(x);
+    for (x->tries = 0; x->tries <= x->retries; ++x->tries){
+        (void)xact_send(x, x->tx, x->tx_len);
+        XACT_AWAIT_REPLY(x, x->req_sc, x->req_addr, x->timeout);
+        if (xact_replied(x)) return XACT_DONE;
+    }
+    return XACT_FAILED;
+    XACT_END(x);
+}
+
+uint8_t xact_request(uint8_t seg, const uint8_t *frame, uint8_t n, uint8_t want_sc, uint8_t addr,
+                     uint8_t retries, xact_done_fn done, void *ctx){
+    if (n > sizeof(s_xact[0].tx)) return 0xFF;
+    const uint8_t i = xact_start(seg, xact_request_body, done, ctx);
+    if (i == 0xFF) return 0xFF;
+    Xact *x = &s_xact[i];
+    memcpy(x->tx, frame, n); x->tx_len = n;
+    x->req_sc = want_sc; x->req_addr = addr;
+    x->retries = retries; x->timeout = XACT_TIMEOUT_TICKS;
+    return i;
+}
+
+void xact_cancel_seg(uint8_t seg){
+    for (uint8_t i = 0; i < XACT_MAX; ++i)
+        if (s_xact[i].state != XS_FREE && s_xact[i].seg == seg) xact_free(i);
+    if (seg < XACT_BUSES) s_owner[seg] = 0xFF;
+}
+
+bool xact_busy(void){
+    for (uint8_t i = 0; i < XACT_MAX; ++i) if (s_xact[i].state != XS_FREE) return true;
+    return false;
+}
+
+bool xact_run(uint8_t seg){
+    uint8_t i = s_owner[seg];
+    if (i == 0xFF){
+        // Oldest queued transaction for this bus (lowest gen distance)
+        uint8_t best = 0xFF, best_age = 0;
+        for (uint8_t k = 0; k < XACT_MAX; ++k){
+            const Xact *q = &s_xact[k];
+            if (q->state != XS_QUEUED || q->seg != seg) continue;
+            const uint8_t age = (uint8_t)((s_gen - q->gen) & 0x7F);
+            if (best == 0xFF || age > best_age){ best = k; best_age = age; }
+        }
+        if (best == 0xFF) return false;
+        i = best; s_owner[seg] = i; s_xact[i].state = XS_RUNNING;
+    }
+    Xact *x = &s_xact[i];
+    const uint8_t r = x->body(x);
+    if (r == XACT_WAITING) return true;
+    s_owner[seg] = 0xFF;
+    x->want_sc = 0;
+    if (x->done) x->done(x, r);
+    xact_free(i);
+    return true;   // the finishing tick still counts as the transaction's
+}
+
+bool xact_rx(uint8_t seg, const uint8_t *pay, uint8_t len){
+    if (seg >= XACT_BUSES || !len) return false;
+    const uint8_t i = s_owner[seg];
+    if (i == 0xFF) return false;
+    Xact *x = &s_xact[i];
+    const uint8_t gen = x->gen, sc = x->want_sc;
+    if (!sc || pay[0] != sc || x->rx_gen == gen) return false;
+    if (x->want_addr != 0xFF && (len < 2 || pay[1] != x->want_addr)) return false;
+    if (len > sizeof(x->rx)) len = sizeof(x->rx);
+    memcpy(x->rx, pay, len); x->rx_len = len;
+    x->rx_gen = gen;         // publish last: RIT (higher priority) sees all or nothing
+    return true;
+}
+
+bool xact_send(Xact *x, const uint8_t *frame, uint8_t n){
+    return (x->seg == XACT_BUS_BIN) ? u2q_push_isr(frame, n) : slvq_push_isr(x->seg, frame, n);
+}
+
+void xact_expect(Xact *x, uint8_t sc, uint8_t addr, uint8_t ticks){
+    x->want_sc = 0;                          // RX stops matching while re-arming
+    x->rx_gen = (uint8_t)~x->gen;
+    x->want_addr = addr;
+    x->deadline = g_tick + ticks;
+    x->want_sc = sc;
+}
+
+bool xact_timed_out(const Xact *x){
+    return (int32_t)(g_tick - x->deadline) >= 0;
+}